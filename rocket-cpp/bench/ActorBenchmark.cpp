@@ -0,0 +1,179 @@
+#include "Benchmark.h"
+
+#include "Actor.h"
+#include "AllocationCounter.h"
+#include "AnimatedSpriteComponent.h"
+#include "BackgroundSpriteComponent.h"
+#include "Game.h"
+#include "SpriteComponent.h"
+
+#include <random>
+#include <vector>
+
+namespace Benchmark {
+
+int RunActorBenchmark(const Options& options, JsonWriter& json) {
+    const int spriteActors = options.GetInt("sprites", 1000);
+    const int animatedActors = options.GetInt("animated", 1000);
+    const int backgroundActors = options.GetInt("backgrounds", 4);
+    const int warmupTicks = options.GetInt("warmup", 60);
+    const int ticks = options.GetInt("ticks", 600);
+    const bool render = options.GetInt("render", 1) != 0;
+    const bool spriteSheet = options.GetInt("sheet", 1) != 0;
+    const bool factories = options.GetInt("factory", 1) != 0;
+    const int pausedPercent = options.GetInt("paused", 0);
+    const bool updateLod = options.GetInt("lod", 1) != 0;
+    const float spread = static_cast<float>(options.GetInt("spread", 0));
+    const float deltaTime = 1.0f / 60.0f;
+
+    json.BeginObject("config");
+    json.Field("sprites", spriteActors);
+    json.Field("animated", animatedActors);
+    json.Field("backgrounds", backgroundActors);
+    json.Field("warmup", warmupTicks);
+    json.Field("ticks", ticks);
+    json.Field("render", render);
+    json.Field("sheet", spriteSheet);
+    json.Field("factory", factories);
+    json.Field("paused", pausedPercent);
+    json.Field("lod", updateLod);
+    json.Field("spread", static_cast<int>(spread));
+    json.EndObject();
+
+    GameConfig config;
+    config.mHeadless = true;
+    config.mFixedDeltaTime = deltaTime;
+    config.mUpdateLod = updateLod;
+
+    Game game(config);
+    if (!game.Initialize()) {
+        game.Shutdown();
+        return 1;
+    }
+
+    std::mt19937 random(1234);
+    // A spread beyond the screen edges puts actors in the reduced-rate and sleeping tiers.
+    std::uniform_real_distribution<float> x(-spread, 1280.0f + spread);
+    std::uniform_real_distribution<float> y(-spread, 720.0f + spread);
+
+    SDL_Texture* spriteTexture = game.GetTexture("assets/rocket1.png");
+    std::vector<std::string> animationFrames = {
+        "assets/rocket1.png",
+        "assets/rocket2.png",
+        "assets/rocket3.png"
+    };
+    const AnimationClip* animationClip = spriteSheet
+        ? game.GetPackedAnimationClip("rocket", animationFrames, 24.0f)
+        : game.GetAnimationClip("rocket-frames", animationFrames, 24.0f);
+    std::vector<SDL_Texture*> backgroundTextures = {
+        game.GetTexture("assets/stars1.png"),
+        game.GetTexture("assets/stars2.png")
+    };
+
+    // With factories, types without per-frame work are left out of the update loops;
+    // plain new keeps every Update and UpdateActor call, as before the factories existed.
+    auto createActor = [&]() {
+        return factories ? game.CreateActor<Actor>() : new Actor(&game);
+    };
+    std::vector<Actor*> actors;
+
+    std::size_t memoryBefore = GetResidentMemory();
+    std::uint64_t allocationsBefore = AllocationCounter::GetCount();
+
+    for (int i = 0; i < spriteActors; ++i) {
+        Actor* actor = createActor();
+        actor->SetPosition(Vector2(x(random), y(random)));
+        actor->SetScale(0.25f);
+        SpriteComponent* sprite = factories ? actor->CreateComponent<SpriteComponent>() : new SpriteComponent(actor);
+        sprite->SetTexture(spriteTexture);
+        actors.emplace_back(actor);
+    }
+
+    for (int i = 0; i < animatedActors; ++i) {
+        Actor* actor = createActor();
+        actor->SetPosition(Vector2(x(random), y(random)));
+        actor->SetScale(0.25f);
+        AnimatedSpriteComponent* animated = factories ? actor->CreateComponent<AnimatedSpriteComponent>() : new AnimatedSpriteComponent(actor);
+        animated->SetAnimationClip(animationClip);
+        actors.emplace_back(actor);
+    }
+
+    for (int i = 0; i < backgroundActors; ++i) {
+        Actor* actor = createActor();
+        actor->SetPosition(Vector2(640.0f, 360.0f));
+        BackgroundSpriteComponent* background = factories ? actor->CreateComponent<BackgroundSpriteComponent>(10 + i)
+                                                          : new BackgroundSpriteComponent(actor, 10 + i);
+        actors.emplace_back(actor);
+        background->SetScreenSize(Vector2(1280.0f, 720.0f));
+        background->SetBackgroundTextures(backgroundTextures);
+        background->SetScrollSpeed(-100.0f * (i + 1));
+    }
+
+    std::uint64_t spawnAllocations = AllocationCounter::GetCount() - allocationsBefore;
+
+    // Pooled or parked actors: they stay in the world but are skipped by the update loop.
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (int i = 0; i < spriteActors + animatedActors; ++i) {
+        if (percent(random) < pausedPercent) {
+            actors[i]->SetState(Actor::EPaused);
+        }
+    }
+
+    int updateCalls = 0;
+    for (auto actor : actors) {
+        updateCalls += actor->GetUpdatingComponentCount() + (actor->HasActorUpdate() ? 1 : 0);
+    }
+    std::size_t memoryAfter = GetResidentMemory();
+    int totalActors = game.GetActorCount();
+    int activeActors = game.GetActiveActorCount();
+
+    for (int i = 0; i < warmupTicks; ++i) {
+        game.Step(deltaTime);
+        if (render) {
+            game.GenerateOutput();
+        }
+    }
+
+    std::uint64_t updateTicks = 0;
+    std::uint64_t renderTicks = 0;
+    std::int64_t actorUpdates = 0;
+    allocationsBefore = AllocationCounter::GetCount();
+
+    for (int i = 0; i < ticks; ++i) {
+        std::uint64_t start = GetTicks();
+        game.Step(deltaTime);
+        std::uint64_t updated = GetTicks();
+        updateTicks += updated - start;
+        actorUpdates += game.GetStats().GetCurrentFrame().mActorUpdates;
+
+        if (render) {
+            game.GenerateOutput();
+            renderTicks += GetTicks() - updated;
+        }
+    }
+
+    std::uint64_t tickAllocations = AllocationCounter::GetCount() - allocationsBefore;
+
+    double updateSeconds = TicksToSeconds(updateTicks);
+    double renderSeconds = TicksToSeconds(renderTicks);
+    double actorTicks = static_cast<double>(totalActors) * ticks;
+
+    json.BeginObject("results");
+    json.Field("actors", totalActors);
+    json.Field("active_actors", activeActors);
+    json.Field("update_ms_per_tick", updateSeconds * 1e3 / ticks);
+    json.Field("render_ms_per_tick", renderSeconds * 1e3 / ticks);
+    json.Field("update_ns_per_actor", updateSeconds * 1e9 / actorTicks);
+    json.Field("virtual_update_calls_per_tick", updateCalls);
+    json.Field("actor_updates_per_tick", static_cast<double>(actorUpdates) / ticks);
+    json.Field("render_ns_per_actor", renderSeconds * 1e9 / actorTicks);
+    json.Field("spawn_allocations", static_cast<std::int64_t>(spawnAllocations));
+    json.Field("allocations_per_tick", static_cast<double>(tickAllocations) / ticks);
+    json.Field("resident_bytes", static_cast<std::int64_t>(memoryAfter));
+    json.Field("spawn_resident_bytes", static_cast<std::int64_t>(memoryAfter) - static_cast<std::int64_t>(memoryBefore));
+    json.EndObject();
+
+    game.Shutdown();
+    return 0;
+}
+} // namespace Benchmark
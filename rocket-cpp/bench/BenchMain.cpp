@@ -0,0 +1,71 @@
+#define SDL_MAIN_HANDLED
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct Suite {
+    const char* mName;
+    const char* mDescription;
+    int (*mRun)(const Benchmark::Options& options, Benchmark::JsonWriter& json);
+};
+
+const Suite sSuites[] = {
+    { "actors", "headless Game with synthetic sprite/animated/background actors", Benchmark::RunActorBenchmark },
+    { "math", "Math.h vector, matrix and quaternion operations, single and batched", Benchmark::RunMathBenchmark },
+    { "music", "generated PCM16 and IMA ADPCM tracks: exact decode, then streamed headless", Benchmark::RunMusicBenchmark },
+    { "particles", "saturated ParticleSystemComponent emitters, update and batched draw", Benchmark::RunParticleBenchmark },
+    { "snapshot", "world snapshot and in-place restore time versus actor count", Benchmark::RunSnapshotBenchmark },
+    { "worlds", "many simulation-only Game worlds stepped in parallel on a thread pool", Benchmark::RunWorldBenchmark },
+};
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr, "Usage: %s <suite> [--out file.json] [--<option> value ...]\n\nSuites:\n", program);
+    for (const Suite& suite : sSuites) {
+        std::fprintf(stderr, "  %-10s %s\n", suite.mName, suite.mDescription);
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    const Suite* selected = nullptr;
+    for (const Suite& suite : sSuites) {
+        if (std::strcmp(suite.mName, argv[1]) == 0) {
+            selected = &suite;
+        }
+    }
+
+    Benchmark::Options options;
+    if (!selected || !options.Parse(argc - 2, argv + 2)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::FILE* out = stdout;
+    if (options.Has("out")) {
+        out = std::fopen(options.GetString("out", "").c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "Failed to open %s\n", options.GetString("out", "").c_str());
+            return 1;
+        }
+    }
+
+    Benchmark::JsonWriter json(out);
+    json.BeginObject();
+    json.Field("suite", selected->mName);
+    int result = selected->mRun(options, json);
+    json.EndObject();
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    return result;
+}
@@ -0,0 +1,195 @@
+#include "Benchmark.h"
+
+#include <chrono>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace Benchmark {
+
+bool Options::Parse(int argc, char* argv[]) {
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            std::fprintf(stderr, "Unexpected argument %s\n", argv[i]);
+            return false;
+        }
+
+        std::string name = arg.substr(2);
+        if (i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0) {
+            mValues[name] = argv[++i];
+        } else {
+            mValues[name] = "1";
+        }
+    }
+
+    return true;
+}
+
+bool Options::Has(const std::string& name) const {
+    return mValues.find(name) != mValues.end();
+}
+
+int Options::GetInt(const std::string& name, int defaultValue) const {
+    auto iter = mValues.find(name);
+    return iter != mValues.end() ? std::atoi(iter->second.c_str()) : defaultValue;
+}
+
+double Options::GetDouble(const std::string& name, double defaultValue) const {
+    auto iter = mValues.find(name);
+    return iter != mValues.end() ? std::atof(iter->second.c_str()) : defaultValue;
+}
+
+std::string Options::GetString(const std::string& name, const std::string& defaultValue) const {
+    auto iter = mValues.find(name);
+    return iter != mValues.end() ? iter->second : defaultValue;
+}
+
+JsonWriter::JsonWriter(std::FILE* file)
+    : mFile(file)
+    , mDepth(0)
+    , mFirstInScope(true) {
+}
+
+void JsonWriter::BeginObject(const char* name) {
+    BeginValue(name);
+    std::fputc('{', mFile);
+    ++mDepth;
+    mFirstInScope = true;
+}
+
+void JsonWriter::EndObject() {
+    --mDepth;
+    std::fputc('\n', mFile);
+    Indent();
+    std::fputc('}', mFile);
+    mFirstInScope = false;
+
+    if (mDepth == 0) {
+        std::fputc('\n', mFile);
+    }
+}
+
+void JsonWriter::BeginArray(const char* name) {
+    BeginValue(name);
+    std::fputc('[', mFile);
+    ++mDepth;
+    mFirstInScope = true;
+}
+
+void JsonWriter::EndArray() {
+    --mDepth;
+    std::fputc('\n', mFile);
+    Indent();
+    std::fputc(']', mFile);
+    mFirstInScope = false;
+}
+
+void JsonWriter::Field(const char* name, const char* value) {
+    BeginValue(name);
+    std::fputc('"', mFile);
+    for (const char* c = value; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', mFile);
+        }
+        std::fputc(*c, mFile);
+    }
+    std::fputc('"', mFile);
+}
+
+void JsonWriter::Field(const char* name, const std::string& value) {
+    Field(name, value.c_str());
+}
+
+void JsonWriter::Field(const char* name, double value) {
+    BeginValue(name);
+    std::fprintf(mFile, "%.6g", value);
+}
+
+void JsonWriter::Field(const char* name, std::int64_t value) {
+    BeginValue(name);
+    std::fprintf(mFile, "%lld", static_cast<long long>(value));
+}
+
+void JsonWriter::Field(const char* name, int value) {
+    Field(name, static_cast<std::int64_t>(value));
+}
+
+void JsonWriter::Field(const char* name, bool value) {
+    BeginValue(name);
+    std::fputs(value ? "true" : "false", mFile);
+}
+
+void JsonWriter::BeginValue(const char* name) {
+    if (mDepth > 0) {
+        if (!mFirstInScope) {
+            std::fputc(',', mFile);
+        }
+        std::fputc('\n', mFile);
+        Indent();
+    }
+
+    if (name) {
+        std::fprintf(mFile, "\"%s\": ", name);
+    }
+
+    mFirstInScope = false;
+}
+
+void JsonWriter::Indent() {
+    for (int i = 0; i < mDepth; ++i) {
+        std::fputs("  ", mFile);
+    }
+}
+
+Timer::Timer() {
+    Reset();
+}
+
+void Timer::Reset() {
+    mStart = GetTicks();
+}
+
+double Timer::GetSeconds() const {
+    return TicksToSeconds(GetTicks() - mStart);
+}
+
+std::uint64_t GetTicks() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+double TicksToSeconds(std::uint64_t ticks) {
+    return static_cast<double>(ticks) * 1e-9;
+}
+
+std::size_t GetResidentMemory() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<std::size_t>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__linux__)
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+
+    long pages = 0;
+    long resident = 0;
+    int read = std::fscanf(file, "%ld %ld", &pages, &resident);
+    std::fclose(file);
+
+    return read == 2 ? static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+} // namespace Benchmark
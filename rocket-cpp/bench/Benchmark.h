@@ -0,0 +1,106 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Benchmark {
+
+class Options {
+public:
+    // Parses "--name value" pairs; returns false on a malformed argument list.
+    bool Parse(int argc, char* argv[]);
+
+    bool Has(const std::string& name) const;
+    int GetInt(const std::string& name, int defaultValue) const;
+    double GetDouble(const std::string& name, double defaultValue) const;
+    std::string GetString(const std::string& name, const std::string& defaultValue) const;
+
+private:
+    std::map<std::string, std::string> mValues;
+};
+
+// Writes JSON with keys in insertion order so output diffs cleanly between commits.
+class JsonWriter {
+public:
+    JsonWriter(std::FILE* file);
+
+    void BeginObject(const char* name = nullptr);
+    void EndObject();
+    void BeginArray(const char* name);
+    void EndArray();
+
+    void Field(const char* name, const char* value);
+    void Field(const char* name, const std::string& value);
+    void Field(const char* name, double value);
+    void Field(const char* name, std::int64_t value);
+    void Field(const char* name, int value);
+    void Field(const char* name, bool value);
+
+private:
+    void BeginValue(const char* name);
+    void Indent();
+
+    std::FILE* mFile;
+    int mDepth;
+    bool mFirstInScope;
+};
+
+class Timer {
+public:
+    Timer();
+
+    void Reset();
+    double GetSeconds() const;
+
+private:
+    std::uint64_t mStart;
+};
+
+std::uint64_t GetTicks();
+double TicksToSeconds(std::uint64_t ticks);
+
+// Resident set / working set size of the process in bytes, or zero if unknown.
+std::size_t GetResidentMemory();
+
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char*>(&value);
+    _ReadWriteBarrier();
+#else
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+#endif
+}
+
+inline void ClobberMemory() {
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    asm volatile(""
+                 :
+                 :
+                 : "memory");
+#endif
+}
+
+int RunActorBenchmark(const Options& options, JsonWriter& json);
+int RunMathBenchmark(const Options& options, JsonWriter& json);
+int RunMusicBenchmark(const Options& options, JsonWriter& json);
+int RunParticleBenchmark(const Options& options, JsonWriter& json);
+int RunSnapshotBenchmark(const Options& options, JsonWriter& json);
+int RunWorldBenchmark(const Options& options, JsonWriter& json);
+} // namespace Benchmark
+
+#endif // BENCHMARK_H
@@ -0,0 +1,239 @@
+#include "Benchmark.h"
+
+#include "Math.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace Benchmark {
+
+namespace {
+
+// Inputs are drawn from small pools indexed with a mask so the compiler cannot
+// constant-fold or hoist an operation out of the timing loop.
+const int PoolSize = 64;
+const int PoolMask = PoolSize - 1;
+
+struct Inputs {
+    std::vector<Vector2> mVector2;
+    std::vector<Vector3> mVector3;
+    std::vector<Matrix3> mMatrix3;
+    std::vector<Matrix4> mMatrix4;
+    std::vector<Quaternion> mQuaternion;
+    std::vector<float> mFactor;
+
+    Inputs(int size, std::mt19937& random) {
+        std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> angle(-Math::Pi, Math::Pi);
+        std::uniform_real_distribution<float> factor(0.0f, 1.0f);
+
+        for (int i = 0; i < size; ++i) {
+            mVector2.emplace_back(value(random), value(random));
+            mVector3.emplace_back(value(random), value(random), value(random));
+
+            mMatrix3.emplace_back(Matrix3::CreateScale(factor(random) + 0.5f) *
+                                  Matrix3::CreateRotation(angle(random)) *
+                                  Matrix3::CreateTranslation(Vector2(value(random), value(random))));
+
+            Vector3 axis = Vector3::Normalize(Vector3(value(random), value(random), value(random) + 20.0f));
+            Quaternion q(axis, angle(random));
+            mQuaternion.emplace_back(q);
+
+            mMatrix4.emplace_back(Matrix4::CreateScale(factor(random) + 0.5f) *
+                                  Matrix4::CreateFromQuaternion(q) *
+                                  Matrix4::CreateTranslation(Vector3(value(random), value(random), value(random))));
+
+            mFactor.emplace_back(factor(random));
+        }
+    }
+};
+
+struct Measurement {
+    double mNsPerOp;
+    double mOpsPerSecond;
+};
+
+// Runs body(iterations) with a growing iteration count until it takes at least
+// minSeconds, then keeps the fastest of several repetitions at that count.
+template <typename Body>
+Measurement Measure(Body body, double opsPerIteration, double minSeconds, int repetitions) {
+    std::int64_t iterations = 1;
+    for (;;) {
+        Timer timer;
+        body(iterations);
+        if (timer.GetSeconds() >= minSeconds || iterations >= (std::int64_t(1) << 40)) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    double best = 0.0;
+    for (int r = 0; r < repetitions; ++r) {
+        Timer timer;
+        body(iterations);
+        double seconds = timer.GetSeconds();
+        if (r == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+
+    double ops = static_cast<double>(iterations) * opsPerIteration;
+    Measurement measurement;
+    measurement.mNsPerOp = best * 1e9 / ops;
+    measurement.mOpsPerSecond = ops / best;
+    return measurement;
+}
+
+class Runner {
+public:
+    Runner(JsonWriter& json, const std::string& filter, int batchSize, double minSeconds, int repetitions)
+        : mJson(json)
+        , mFilter(filter)
+        , mBatchSize(batchSize)
+        , mMinSeconds(minSeconds)
+        , mRepetitions(repetitions) {
+    }
+
+    // op(i) computes one result from the input pools at index i.
+    template <typename Op>
+    void Run(const char* name, Op op) {
+        if (!mFilter.empty() && std::string(name).find(mFilter) == std::string::npos) {
+            return;
+        }
+
+        Measurement single = Measure([&](std::int64_t iterations) {
+            for (std::int64_t i = 0; i < iterations; ++i) {
+                auto result = op(static_cast<int>(i) & PoolMask);
+                DoNotOptimize(result);
+            }
+        },
+                                     1.0, mMinSeconds, mRepetitions);
+
+        typedef decltype(op(0)) Result;
+        std::vector<Result> output(mBatchSize);
+        Measurement batched = Measure([&](std::int64_t iterations) {
+            for (std::int64_t n = 0; n < iterations; ++n) {
+                for (int i = 0; i < mBatchSize; ++i) {
+                    output[i] = op(i & PoolMask);
+                }
+                DoNotOptimize(output.data());
+                ClobberMemory();
+            }
+        },
+                                      static_cast<double>(mBatchSize), mMinSeconds, mRepetitions);
+
+        mJson.BeginObject();
+        mJson.Field("name", name);
+        mJson.Field("single_ns_per_op", single.mNsPerOp);
+        mJson.Field("single_ops_per_second", single.mOpsPerSecond);
+        mJson.Field("batched_ns_per_op", batched.mNsPerOp);
+        mJson.Field("batched_ops_per_second", batched.mOpsPerSecond);
+        mJson.EndObject();
+    }
+
+private:
+    JsonWriter& mJson;
+    std::string mFilter;
+    int mBatchSize;
+    double mMinSeconds;
+    int mRepetitions;
+};
+} // namespace
+
+int RunMathBenchmark(const Options& options, JsonWriter& json) {
+    const int batchSize = std::max(1, options.GetInt("batch", 1024));
+    const double minSeconds = options.GetDouble("min-time", 0.05);
+    const int repetitions = std::max(1, options.GetInt("repetitions", 5));
+    const std::string filter = options.GetString("filter", "");
+
+    json.BeginObject("config");
+    json.Field("batch", batchSize);
+    json.Field("min_time", minSeconds);
+    json.Field("repetitions", repetitions);
+    json.Field("filter", filter);
+    json.EndObject();
+
+    std::mt19937 random(1234);
+    Inputs in(PoolSize, random);
+    Runner runner(json, filter, batchSize, minSeconds, repetitions);
+
+    json.BeginArray("results");
+
+    runner.Run("Vector2::operator+", [&](int i) {
+        return in.mVector2[i] + in.mVector2[(i + 1) & PoolMask];
+    });
+    runner.Run("Vector2::Dot", [&](int i) {
+        return Vector2::Dot(in.mVector2[i], in.mVector2[(i + 1) & PoolMask]);
+    });
+    runner.Run("Vector2::Normalize", [&](int i) {
+        return Vector2::Normalize(in.mVector2[i]);
+    });
+    runner.Run("Vector2::Lerp", [&](int i) {
+        return Vector2::Lerp(in.mVector2[i], in.mVector2[(i + 1) & PoolMask], in.mFactor[i]);
+    });
+    runner.Run("Vector2::Transform", [&](int i) {
+        return Vector2::Transform(in.mVector2[i], in.mMatrix3[(i + 1) & PoolMask]);
+    });
+
+    runner.Run("Vector3::operator+", [&](int i) {
+        return in.mVector3[i] + in.mVector3[(i + 1) & PoolMask];
+    });
+    runner.Run("Vector3::Dot", [&](int i) {
+        return Vector3::Dot(in.mVector3[i], in.mVector3[(i + 1) & PoolMask]);
+    });
+    runner.Run("Vector3::Cross", [&](int i) {
+        return Vector3::Cross(in.mVector3[i], in.mVector3[(i + 1) & PoolMask]);
+    });
+    runner.Run("Vector3::Normalize", [&](int i) {
+        return Vector3::Normalize(in.mVector3[i]);
+    });
+    runner.Run("Vector3::Transform(Matrix4)", [&](int i) {
+        return Vector3::Transform(in.mVector3[i], in.mMatrix4[(i + 1) & PoolMask]);
+    });
+    runner.Run("Vector3::TransformWithPerspDiv", [&](int i) {
+        return Vector3::TransformWithPerspDiv(in.mVector3[i], in.mMatrix4[(i + 1) & PoolMask]);
+    });
+    runner.Run("Vector3::Transform(Quaternion)", [&](int i) {
+        return Vector3::Transform(in.mVector3[i], in.mQuaternion[(i + 1) & PoolMask]);
+    });
+
+    runner.Run("Matrix3::operator*", [&](int i) {
+        return in.mMatrix3[i] * in.mMatrix3[(i + 1) & PoolMask];
+    });
+    runner.Run("Matrix3::CreateRotation", [&](int i) {
+        return Matrix3::CreateRotation(in.mFactor[i]);
+    });
+
+    runner.Run("Matrix4::operator*", [&](int i) {
+        return in.mMatrix4[i] * in.mMatrix4[(i + 1) & PoolMask];
+    });
+    runner.Run("Matrix4::Invert", [&](int i) {
+        Matrix4 m = in.mMatrix4[i];
+        m.Invert();
+        return m;
+    });
+    runner.Run("Matrix4::CreateFromQuaternion", [&](int i) {
+        return Matrix4::CreateFromQuaternion(in.mQuaternion[i]);
+    });
+    runner.Run("Matrix4::CreateLookAt", [&](int i) {
+        return Matrix4::CreateLookAt(in.mVector3[i], in.mVector3[(i + 1) & PoolMask], Vector3::UnitZ);
+    });
+    runner.Run("Matrix4::GetScale", [&](int i) {
+        return in.mMatrix4[i].GetScale();
+    });
+
+    runner.Run("Quaternion::Lerp", [&](int i) {
+        return Quaternion::Lerp(in.mQuaternion[i], in.mQuaternion[(i + 1) & PoolMask], in.mFactor[i]);
+    });
+    runner.Run("Quaternion::Slerp", [&](int i) {
+        return Quaternion::Slerp(in.mQuaternion[i], in.mQuaternion[(i + 1) & PoolMask], in.mFactor[i]);
+    });
+    runner.Run("Quaternion::Concatenate", [&](int i) {
+        return Quaternion::Concatenate(in.mQuaternion[i], in.mQuaternion[(i + 1) & PoolMask]);
+    });
+
+    json.EndArray();
+    return 0;
+}
+} // namespace Benchmark
@@ -0,0 +1,319 @@
+#include "Benchmark.h"
+
+#include "Game.h"
+#include "MusicStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace Benchmark {
+
+namespace {
+
+const int SampleRate = 48000;
+const int Channels = 2;
+// Stereo IMA ADPCM block: 4 header bytes per channel, then 1016 bytes of nibbles.
+const int AdpcmBlockAlign = 1024;
+const int AdpcmBlockFrames = (AdpcmBlockAlign - 4 * Channels) * 2 / Channels + 1;
+
+const int ImaIndexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+const int ImaStepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+void Write16(std::vector<unsigned char>& out, int value) {
+    out.push_back(static_cast<unsigned char>(value & 0xff));
+    out.push_back(static_cast<unsigned char>((value >> 8) & 0xff));
+}
+
+void Write32(std::vector<unsigned char>& out, std::uint32_t value) {
+    Write16(out, static_cast<int>(value & 0xffff));
+    Write16(out, static_cast<int>(value >> 16));
+}
+
+void WriteTag(std::vector<unsigned char>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+// Interleaved stereo: a tone on each channel, different so a channel swap shows up.
+std::vector<std::int16_t> MakeSignal(int frames) {
+    std::vector<std::int16_t> samples(frames * Channels);
+    for (int i = 0; i < frames; ++i) {
+        double t = static_cast<double>(i) / SampleRate;
+        samples[i * Channels] = static_cast<std::int16_t>(16000.0 * std::sin(2.0 * 3.14159265358979 * 440.0 * t));
+        samples[i * Channels + 1] = static_cast<std::int16_t>(9000.0 * std::sin(2.0 * 3.14159265358979 * 660.0 * t));
+    }
+    return samples;
+}
+
+std::vector<unsigned char> MakeWavHeader(std::uint16_t format, int blockAlign, int bitsPerSample, int samplesPerBlock, std::uint32_t dataBytes) {
+    bool adpcm = samplesPerBlock > 0;
+    std::uint32_t formatBytes = adpcm ? 20 : 16;
+
+    std::vector<unsigned char> out;
+    WriteTag(out, "RIFF");
+    Write32(out, 4 + 8 + formatBytes + 8 + dataBytes);
+    WriteTag(out, "WAVE");
+    WriteTag(out, "fmt ");
+    Write32(out, formatBytes);
+    Write16(out, format);
+    Write16(out, Channels);
+    Write32(out, SampleRate);
+    Write32(out, adpcm ? static_cast<std::uint32_t>(SampleRate) * blockAlign / samplesPerBlock
+                       : static_cast<std::uint32_t>(SampleRate) * blockAlign);
+    Write16(out, blockAlign);
+    Write16(out, bitsPerSample);
+    if (adpcm) {
+        Write16(out, 2);
+        Write16(out, samplesPerBlock);
+    }
+    WriteTag(out, "data");
+    Write32(out, dataBytes);
+    return out;
+}
+
+bool WriteFile(const std::string& fileName, const std::vector<unsigned char>& bytes) {
+    std::FILE* file = std::fopen(fileName.c_str(), "wb");
+    if (!file) {
+        std::fprintf(stderr, "Cannot write %s\n", fileName.c_str());
+        return false;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Fills expected with what a correct decoder produces: the samples themselves.
+bool WritePcm16(const std::string& fileName, const std::vector<std::int16_t>& samples, std::vector<float>& expected) {
+    std::vector<unsigned char> bytes = MakeWavHeader(1, Channels * 2, 16, 0, static_cast<std::uint32_t>(samples.size() * 2));
+    expected.clear();
+    for (std::int16_t sample : samples) {
+        Write16(bytes, sample);
+        expected.push_back(sample / 32768.0f);
+    }
+    return WriteFile(fileName, bytes);
+}
+
+// One IMA ADPCM step; predictor and index follow the decoder, so expected output is exact.
+int EncodeNibble(int sample, int& predictor, int& index) {
+    int step = ImaStepTable[index];
+    int difference = sample - predictor;
+    int nibble = 0;
+    if (difference < 0) {
+        nibble = 8;
+        difference = -difference;
+    }
+    if (difference >= step) {
+        nibble |= 4;
+        difference -= step;
+    }
+    if (difference >= step >> 1) {
+        nibble |= 2;
+        difference -= step >> 1;
+    }
+    if (difference >= step >> 2) {
+        nibble |= 1;
+    }
+
+    int delta = step >> 3;
+    if (nibble & 1) {
+        delta += step >> 2;
+    }
+    if (nibble & 2) {
+        delta += step >> 1;
+    }
+    if (nibble & 4) {
+        delta += step;
+    }
+    if (nibble & 8) {
+        delta = -delta;
+    }
+
+    predictor = std::min(std::max(predictor + delta, -32768), 32767);
+    index = std::min(std::max(index + ImaIndexTable[nibble], 0), 88);
+    return nibble;
+}
+
+// Expects a whole number of blocks.
+bool WriteImaAdpcm(const std::string& fileName, const std::vector<std::int16_t>& samples, std::vector<float>& expected) {
+    int frames = static_cast<int>(samples.size()) / Channels;
+    int blocks = frames / AdpcmBlockFrames;
+    std::vector<unsigned char> bytes = MakeWavHeader(0x11, AdpcmBlockAlign, 4, AdpcmBlockFrames,
+                                                     static_cast<std::uint32_t>(blocks * AdpcmBlockAlign));
+
+    expected.assign(static_cast<std::size_t>(blocks) * AdpcmBlockFrames * Channels, 0.0f);
+    int index[Channels] = { 0, 0 };
+
+    for (int block = 0; block < blocks; ++block) {
+        int first = block * AdpcmBlockFrames;
+        int predictor[Channels];
+
+        // The header carries the block's first sample verbatim.
+        for (int c = 0; c < Channels; ++c) {
+            predictor[c] = samples[first * Channels + c];
+            Write16(bytes, predictor[c]);
+            bytes.push_back(static_cast<unsigned char>(index[c]));
+            bytes.push_back(0);
+            expected[first * Channels + c] = predictor[c] / 32768.0f;
+        }
+
+        // Four bytes (eight frames) per channel at a time, low nibble first.
+        for (int group = 0; group < (AdpcmBlockFrames - 1) / 8; ++group) {
+            for (int c = 0; c < Channels; ++c) {
+                for (int pair = 0; pair < 4; ++pair) {
+                    int packed = 0;
+                    for (int half = 0; half < 2; ++half) {
+                        int frame = first + 1 + group * 8 + pair * 2 + half;
+                        packed |= EncodeNibble(samples[frame * Channels + c], predictor[c], index[c]) << (half * 4);
+                        expected[frame * Channels + c] = predictor[c] / 32768.0f;
+                    }
+                    bytes.push_back(static_cast<unsigned char>(packed));
+                }
+            }
+        }
+    }
+
+    return WriteFile(fileName, bytes);
+}
+
+// Drains the stream as fast as the worker decodes. The device runs at the file rate, so
+// resampling is the identity and the output must equal the decoded samples exactly.
+void CheckDecode(const std::string& fileName, const std::vector<float>& expected, JsonWriter& json) {
+    MusicStream stream(SampleRate, 250);
+    std::vector<float> decoded;
+    bool opened = stream.Open(fileName, false);
+
+    std::vector<float> chunk(512 * Channels);
+    while (opened && !stream.IsFinished()) {
+        int frames = stream.Read(chunk.data(), 512);
+        if (frames == 0) {
+            SDL_Delay(1);
+        }
+        decoded.insert(decoded.end(), chunk.begin(), chunk.begin() + frames * Channels);
+    }
+    stream.Close();
+
+    std::size_t compared = std::min(decoded.size(), expected.size());
+    float maxError = 0.0f;
+    for (std::size_t i = 0; i < compared; ++i) {
+        maxError = std::max(maxError, std::fabs(decoded[i] - expected[i]));
+    }
+
+    // Interpolation needs the following frame, so the very last one is never produced.
+    int decodedFrames = static_cast<int>(decoded.size()) / Channels;
+    int expectedFrames = static_cast<int>(expected.size()) / Channels;
+    bool exact = opened && decodedFrames >= expectedFrames - 1 && maxError == 0.0f;
+
+    json.Field("decoded_frames", decodedFrames);
+    json.Field("expected_frames", expectedFrames);
+    json.Field("decode_max_error", static_cast<double>(maxError));
+    json.Field("decode_exact", exact);
+}
+
+// Plays the file as the game's looping music track in a headless Game (dummy audio driver)
+// at roughly 60 frames per second of wall time.
+void CheckStreaming(const std::string& fileName, int bufferMs, double seconds, JsonWriter& json) {
+    const float deltaTime = 1.0f / 60.0f;
+
+    GameConfig config;
+    config.mHeadless = true;
+    config.mFixedDeltaTime = deltaTime;
+    config.mFlightRecorder = false;
+    config.mMusicFile = fileName;
+    config.mMusicBufferMs = bufferMs;
+
+    Game game(config);
+    bool initialized = game.Initialize();
+
+    Uint32 callbacks = 0;
+    Uint32 underruns = 0;
+    float minBufferedMs = 0.0f;
+    double bufferedMsSum = 0.0;
+    int bufferedSamples = 0;
+
+    Timer timer;
+    while (initialized && timer.GetSeconds() < seconds) {
+        game.Step(deltaTime);
+        game.GenerateOutput();
+        SDL_Delay(16);
+
+        AudioSystem::CallbackStats audio = game.GetAudio().ConsumeCallbackStats();
+        if (audio.mCallbacks == 0) {
+            continue;
+        }
+
+        callbacks += audio.mCallbacks;
+        underruns = audio.mMusicUnderruns;
+        minBufferedMs = bufferedSamples == 0 ? audio.mMusicBufferedMs : std::min(minBufferedMs, audio.mMusicBufferedMs);
+        bufferedMsSum += audio.mMusicBufferedMs;
+        ++bufferedSamples;
+    }
+
+    game.Shutdown();
+
+    json.Field("callbacks", static_cast<std::int64_t>(callbacks));
+    json.Field("music_underruns", static_cast<std::int64_t>(underruns));
+    json.Field("buffered_ms_min", static_cast<double>(minBufferedMs));
+    json.Field("buffered_ms_mean", bufferedSamples > 0 ? bufferedMsSum / bufferedSamples : 0.0);
+    json.Field("streamed", initialized && callbacks > 0 && bufferedSamples > 0 && minBufferedMs > 0.0f);
+}
+} // namespace
+
+int RunMusicBenchmark(const Options& options, JsonWriter& json) {
+    const int blocks = options.GetInt("blocks", 48);
+    const int bufferMs = options.GetInt("buffer-ms", 250);
+    const double seconds = options.GetDouble("seconds", 2.0);
+    const std::string prefix = options.GetString("file-prefix", "music-bench");
+
+    json.BeginObject("config");
+    json.Field("blocks", blocks);
+    json.Field("buffer_ms", bufferMs);
+    json.Field("seconds", seconds);
+    json.Field("file_prefix", prefix);
+    json.EndObject();
+
+    // A whole number of ADPCM blocks; the PCM file carries the same signal.
+    std::vector<std::int16_t> samples = MakeSignal(blocks * AdpcmBlockFrames);
+
+    struct Track {
+        const char* mName;
+        std::string mFileName;
+        bool (*mWrite)(const std::string&, const std::vector<std::int16_t>&, std::vector<float>&);
+    };
+    const Track tracks[] = {
+        { "pcm16", prefix + "-pcm16.wav", WritePcm16 },
+        { "ima_adpcm", prefix + "-ima-adpcm.wav", WriteImaAdpcm }
+    };
+
+    bool ok = true;
+    json.BeginArray("results");
+    for (const Track& track : tracks) {
+        std::vector<float> expected;
+        if (!track.mWrite(track.mFileName, samples, expected)) {
+            ok = false;
+            continue;
+        }
+
+        json.BeginObject();
+        json.Field("encoding", track.mName);
+        CheckDecode(track.mFileName, expected, json);
+        CheckStreaming(track.mFileName, bufferMs, seconds, json);
+        json.EndObject();
+
+        std::remove(track.mFileName.c_str());
+    }
+    json.EndArray();
+
+    return ok ? 0 : 1;
+}
+} // namespace Benchmark
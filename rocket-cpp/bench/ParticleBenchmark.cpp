@@ -0,0 +1,90 @@
+#include "Benchmark.h"
+
+#include "Actor.h"
+#include "AllocationCounter.h"
+#include "Game.h"
+#include "ParticleSystemComponent.h"
+
+#include <vector>
+
+namespace Benchmark {
+
+int RunParticleBenchmark(const Options& options, JsonWriter& json) {
+    const int emitters = options.GetInt("emitters", 10);
+    const int particlesPerEmitter = options.GetInt("particles", 10000);
+    const int ticks = options.GetInt("ticks", 600);
+    const bool render = options.GetInt("render", 1) != 0;
+    const float deltaTime = 1.0f / 60.0f;
+
+    json.BeginObject("config");
+    json.Field("emitters", emitters);
+    json.Field("particles", particlesPerEmitter);
+    json.Field("ticks", ticks);
+    json.Field("render", render);
+    json.EndObject();
+
+    GameConfig config;
+    config.mHeadless = true;
+    config.mFixedDeltaTime = deltaTime;
+
+    Game game(config);
+    if (!game.Initialize()) {
+        game.Shutdown();
+        return 1;
+    }
+
+    // Lifetimes of one second and an emit rate that refills the budget in the
+    // same time keep every emitter saturated after warmup.
+    std::vector<ParticleSystemComponent*> systems;
+    for (int i = 0; i < emitters; ++i) {
+        Actor* actor = game.CreateActor<Actor>();
+        actor->SetPosition(Vector2(640.0f, 360.0f));
+        ParticleSystemComponent* system = actor->CreateComponent<ParticleSystemComponent>(particlesPerEmitter);
+        system->SetEmitRate(static_cast<float>(particlesPerEmitter));
+        system->SetLifetime(0.9f, 1.0f);
+        system->SetSpeed(50.0f, 300.0f);
+        system->SetGravity(Vector2(0.0f, 100.0f));
+        system->SetDrag(0.5f);
+        systems.emplace_back(system);
+    }
+
+    for (int i = 0; i < 90; ++i) {
+        game.Step(deltaTime);
+    }
+
+    std::uint64_t updateTicks = 0;
+    std::uint64_t renderTicks = 0;
+    double particleTicks = 0.0;
+    std::uint64_t allocationsBefore = AllocationCounter::GetCount();
+
+    for (int i = 0; i < ticks; ++i) {
+        for (auto system : systems) {
+            particleTicks += system->GetParticleCount();
+        }
+
+        std::uint64_t start = GetTicks();
+        game.Step(deltaTime);
+        std::uint64_t updated = GetTicks();
+        updateTicks += updated - start;
+
+        if (render) {
+            game.GenerateOutput();
+            renderTicks += GetTicks() - updated;
+        }
+    }
+
+    std::uint64_t allocations = AllocationCounter::GetCount() - allocationsBefore;
+
+    json.BeginObject("results");
+    json.Field("average_particles", particleTicks / ticks);
+    json.Field("update_ms_per_tick", TicksToSeconds(updateTicks) * 1e3 / ticks);
+    json.Field("render_ms_per_tick", TicksToSeconds(renderTicks) * 1e3 / ticks);
+    json.Field("update_ns_per_particle", TicksToSeconds(updateTicks) * 1e9 / particleTicks);
+    json.Field("render_ns_per_particle", TicksToSeconds(renderTicks) * 1e9 / particleTicks);
+    json.Field("allocations_per_tick", static_cast<double>(allocations) / ticks);
+    json.EndObject();
+
+    game.Shutdown();
+    return 0;
+}
+} // namespace Benchmark
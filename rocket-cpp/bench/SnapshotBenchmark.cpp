@@ -0,0 +1,143 @@
+#include "Benchmark.h"
+
+#include "Actor.h"
+#include "AnimatedSpriteComponent.h"
+#include "Game.h"
+#include "WorldSnapshot.h"
+
+#include <random>
+#include <vector>
+
+namespace Benchmark {
+
+namespace {
+
+void SpawnActors(Game& game, const AnimationClip* clip, int count, unsigned int seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> x(0.0f, 1280.0f);
+    std::uniform_real_distribution<float> y(0.0f, 720.0f);
+
+    for (int i = 0; i < count; ++i) {
+        Actor* actor = game.CreateActor<Actor>();
+        actor->SetPosition(Vector2(x(random), y(random)));
+        actor->SetRotation(x(random));
+        AnimatedSpriteComponent* animated = actor->CreateComponent<AnimatedSpriteComponent>();
+        animated->SetAnimationClip(clip);
+    }
+}
+
+// Holds right for the first half of the rollout and up for the second.
+void Rollout(Game& game, int ticks, float deltaTime) {
+    std::vector<KeyChange> changes;
+    for (int tick = 0; tick < ticks; ++tick) {
+        changes.clear();
+        if (tick == 0 || tick == ticks / 2) {
+            KeyChange change;
+            change.mScancode = tick == 0 ? SDL_SCANCODE_D : SDL_SCANCODE_W;
+            change.mDown = true;
+            change.mTickOffset = 0;
+            changes.emplace_back(change);
+        }
+        game.ApplyInput(changes);
+        game.Step(deltaTime);
+    }
+}
+} // namespace
+
+int RunSnapshotBenchmark(const Options& options, JsonWriter& json) {
+    const int minActors = options.GetInt("min-actors", 100);
+    const int maxActors = options.GetInt("max-actors", 25600);
+    const int repetitions = options.GetInt("repetitions", 200);
+    const int rolloutTicks = options.GetInt("rollout", 60);
+    const float deltaTime = 1.0f / 60.0f;
+
+    json.BeginObject("config");
+    json.Field("min_actors", minActors);
+    json.Field("max_actors", maxActors);
+    json.Field("repetitions", repetitions);
+    json.Field("rollout", rolloutTicks);
+    json.EndObject();
+
+    json.BeginArray("results");
+
+    for (int actors = minActors; actors <= maxActors; actors *= 4) {
+        GameConfig config;
+        config.mSimulationOnly = true;
+        config.mFixedDeltaTime = deltaTime;
+
+        Game game(config);
+        if (!game.Initialize()) {
+            game.Shutdown();
+            return 1;
+        }
+
+        const AnimationClip* clip = game.GetPackedAnimationClip("rocket",
+                                                                { "assets/rocket1.png",
+                                                                  "assets/rocket2.png",
+                                                                  "assets/rocket3.png" },
+                                                                24.0f);
+        SpawnActors(game, clip, actors, 1234);
+
+        // Fills the ship's exhaust so particle buffers are part of the state.
+        Rollout(game, 60, deltaTime);
+
+        WorldSnapshot start;
+        WorldSnapshot check;
+        game.SaveSnapshot(start);
+
+        std::uint64_t saveTicks = 0;
+        std::uint64_t restoreTicks = 0;
+        bool restored = true;
+        for (int i = 0; i < repetitions; ++i) {
+            std::uint64_t begin = GetTicks();
+            game.SaveSnapshot(check);
+            std::uint64_t saved = GetTicks();
+            restored = game.RestoreSnapshot(check) && restored;
+            restoreTicks += GetTicks() - saved;
+            saveTicks += saved - begin;
+        }
+
+        // A rollout that spawns actors, then back: the world must match the snapshot exactly.
+        Rollout(game, rolloutTicks, deltaTime);
+        SpawnActors(game, clip, 16, 99);
+        Rollout(game, rolloutTicks, deltaTime);
+        restored = game.RestoreSnapshot(start) && restored;
+        game.SaveSnapshot(check);
+        bool restoreExact = check.Equals(start);
+
+        // The same rollout from the same snapshot must end in the same state.
+        WorldSnapshot first;
+        Rollout(game, rolloutTicks, deltaTime);
+        game.SaveSnapshot(first);
+        restored = game.RestoreSnapshot(start) && restored;
+        Rollout(game, rolloutTicks, deltaTime);
+        game.SaveSnapshot(check);
+        bool deterministic = check.Equals(first);
+
+        double saveSeconds = TicksToSeconds(saveTicks) / repetitions;
+        double restoreSeconds = TicksToSeconds(restoreTicks) / repetitions;
+        int totalActors = game.GetActorCount();
+
+        json.BeginObject();
+        json.Field("actors", totalActors);
+        json.Field("snapshot_bytes", static_cast<std::int64_t>(start.GetSize()));
+        json.Field("save_us", saveSeconds * 1e6);
+        json.Field("restore_us", restoreSeconds * 1e6);
+        json.Field("save_ns_per_actor", saveSeconds * 1e9 / totalActors);
+        json.Field("restore_ns_per_actor", restoreSeconds * 1e9 / totalActors);
+        json.Field("restore_ok", restored);
+        json.Field("restore_exact", restoreExact);
+        json.Field("rollout_deterministic", deterministic);
+        json.EndObject();
+
+        game.Shutdown();
+
+        if (actors <= 0) {
+            break;
+        }
+    }
+
+    json.EndArray();
+    return 0;
+}
+} // namespace Benchmark
@@ -0,0 +1,172 @@
+#include "Benchmark.h"
+
+#include "Actor.h"
+#include "AnimatedSpriteComponent.h"
+#include "Game.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace Benchmark {
+
+namespace {
+
+// Worlds are created with plain new, which before C++17 only guarantees fundamental alignment.
+static_assert(alignof(Game) <= alignof(std::max_align_t), "Game must not be over-aligned");
+
+// Each world steers its ship with its own key pattern so the worlds diverge.
+void ScriptInput(int world, int tick, std::vector<KeyChange>& changes) {
+    static const SDL_Scancode keys[] = { SDL_SCANCODE_W, SDL_SCANCODE_A, SDL_SCANCODE_S, SDL_SCANCODE_D };
+    const int period = 30;
+
+    changes.clear();
+    int phase = (tick + world * 7) % period;
+    if (phase == 0 || phase == period / 2) {
+        KeyChange change;
+        change.mScancode = static_cast<Uint16>(keys[(tick / period + world) % 4]);
+        change.mDown = phase == 0;
+        change.mTickOffset = static_cast<Uint16>((world * 977) % KeyChange::TickEnd);
+        changes.emplace_back(change);
+    }
+}
+
+void BuildWorld(Game& game, int index, int actors) {
+    std::mt19937 random(1234 + index);
+    std::uniform_real_distribution<float> x(-640.0f, 1920.0f);
+    std::uniform_real_distribution<float> y(-360.0f, 1080.0f);
+
+    const AnimationClip* clip = game.GetPackedAnimationClip("rocket",
+                                                            { "assets/rocket1.png",
+                                                              "assets/rocket2.png",
+                                                              "assets/rocket3.png" },
+                                                            24.0f);
+
+    for (int i = 0; i < actors; ++i) {
+        Actor* actor = game.CreateActor<Actor>();
+        actor->SetPosition(Vector2(x(random), y(random)));
+        AnimatedSpriteComponent* animated = actor->CreateComponent<AnimatedSpriteComponent>();
+        animated->SetAnimationClip(clip);
+    }
+}
+} // namespace
+
+int RunWorldBenchmark(const Options& options, JsonWriter& json) {
+    const int worldCount = options.GetInt("worlds", 256);
+    const int actors = options.GetInt("actors", 50);
+    const int ticks = options.GetInt("ticks", 600);
+    const int batch = options.GetInt("batch", 60);
+    const bool serialBaseline = options.GetInt("baseline", 1) != 0;
+    const float deltaTime = 1.0f / 60.0f;
+
+    ThreadPool pool(options.GetInt("threads", 0));
+
+    json.BeginObject("config");
+    json.Field("worlds", worldCount);
+    json.Field("actors", actors);
+    json.Field("ticks", ticks);
+    json.Field("batch", batch);
+    json.Field("threads", pool.GetThreadCount());
+    json.Field("baseline", serialBaseline);
+    json.EndObject();
+
+    GameConfig config;
+    config.mSimulationOnly = true;
+    config.mFixedDeltaTime = deltaTime;
+    config.mQualityGovernor = false;
+
+    std::vector<Game*> worlds(worldCount, nullptr);
+    std::vector<int> failed(worldCount, 0);
+
+    Timer timer;
+    pool.ParallelFor(worldCount, [&](int index) {
+        Game* game = new Game(config);
+        if (game->Initialize()) {
+            BuildWorld(*game, index, actors);
+        } else {
+            failed[index] = 1;
+        }
+        worlds[index] = game;
+    });
+    double createSeconds = timer.GetSeconds();
+
+    auto destroyWorlds = [&]() {
+        pool.ParallelFor(worldCount, [&](int index) {
+            worlds[index]->Shutdown();
+            delete worlds[index];
+            worlds[index] = nullptr;
+        });
+    };
+
+    int failures = static_cast<int>(std::count(failed.begin(), failed.end(), 1));
+    if (failures > 0) {
+        std::fprintf(stderr, "%d worlds failed to initialize\n", failures);
+        destroyWorlds();
+        return 1;
+    }
+
+    // Every job advances one world by up to a batch of ticks, so threads only meet
+    // at batch boundaries; between them the worlds share nothing.
+    int tick = 0;
+    auto runTicks = [&](int count, bool parallel) {
+        int end = tick + count;
+        while (tick < end) {
+            int span = std::min(batch, end - tick);
+            auto job = [&](int index) {
+                std::vector<KeyChange> changes;
+                for (int t = tick; t < tick + span; ++t) {
+                    ScriptInput(index, t, changes);
+                    worlds[index]->ApplyInput(changes);
+                    worlds[index]->Step(deltaTime);
+                }
+            };
+
+            if (parallel) {
+                pool.ParallelFor(worldCount, job);
+            } else {
+                for (int index = 0; index < worldCount; ++index) {
+                    job(index);
+                }
+            }
+            tick += span;
+        }
+    };
+
+    runTicks(batch, true);
+
+    timer.Reset();
+    runTicks(ticks, true);
+    double parallelSeconds = timer.GetSeconds();
+
+    double serialSeconds = 0.0;
+    if (serialBaseline) {
+        timer.Reset();
+        runTicks(ticks, false);
+        serialSeconds = timer.GetSeconds();
+    }
+
+    int worldActors = worlds.empty() ? 0 : worlds[0]->GetActorCount();
+
+    timer.Reset();
+    destroyWorlds();
+    double destroySeconds = timer.GetSeconds();
+
+    double worldTicks = static_cast<double>(worldCount) * ticks;
+
+    json.BeginObject("results");
+    json.Field("actors_per_world", worldActors);
+    json.Field("create_ms_per_world", createSeconds * 1e3 / worldCount);
+    json.Field("destroy_ms_per_world", destroySeconds * 1e3 / worldCount);
+    json.Field("world_ticks_per_second", worldTicks / parallelSeconds);
+    json.Field("actor_ticks_per_second", worldTicks * worldActors / parallelSeconds);
+    if (serialBaseline) {
+        json.Field("serial_world_ticks_per_second", worldTicks / serialSeconds);
+        json.Field("parallel_speedup", serialSeconds / parallelSeconds);
+    }
+    json.EndObject();
+
+    return 0;
+}
+} // namespace Benchmark
@@ -0,0 +1,54 @@
+#include "ActionMap.h"
+
+#include <cstring>
+
+ActionMap::ActionMap() {
+    std::memset(mBindings, ENone, sizeof(mBindings));
+    std::memset(mKeyDown, 0, sizeof(mKeyDown));
+
+    for (int i = 0; i < ENumActions; ++i) {
+        mHeldKeys[i] = 0;
+        mHeldSince[i] = 0;
+        mHeldTime[i] = 0;
+    }
+}
+
+void ActionMap::Bind(SDL_Scancode scancode, Action action) {
+    mBindings[scancode] = static_cast<Sint8>(action);
+}
+
+void ActionMap::BeginTick() {
+    for (int i = 0; i < ENumActions; ++i) {
+        mHeldSince[i] = 0;
+        mHeldTime[i] = 0;
+    }
+}
+
+void ActionMap::ApplyChange(const KeyChange& change) {
+    if (change.mScancode >= SDL_NUM_SCANCODES || mKeyDown[change.mScancode] == change.mDown) {
+        return;
+    }
+    mKeyDown[change.mScancode] = change.mDown;
+
+    int action = mBindings[change.mScancode];
+    if (action == ENone) {
+        return;
+    }
+
+    // Several keys may share an action; only the first press and last release count.
+    if (change.mDown) {
+        if (mHeldKeys[action]++ == 0) {
+            mHeldSince[action] = change.mTickOffset;
+        }
+    } else if (--mHeldKeys[action] == 0 && change.mTickOffset > mHeldSince[action]) {
+        mHeldTime[action] += change.mTickOffset - mHeldSince[action];
+    }
+}
+
+void ActionMap::EndTick() {
+    for (int i = 0; i < ENumActions; ++i) {
+        if (mHeldKeys[i] > 0) {
+            mHeldTime[i] += KeyChange::TickEnd - mHeldSince[i];
+        }
+    }
+}
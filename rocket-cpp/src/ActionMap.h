@@ -0,0 +1,56 @@
+#ifndef ACTION_MAP_H
+#define ACTION_MAP_H
+
+#include "SDL.h"
+
+// A key transition placed inside the tick that consumes it.
+struct KeyChange {
+    static const Uint16 TickEnd = 0xffff;
+
+    Uint16 mScancode;
+    bool mDown;
+    // Position within the tick, 0 at its start and TickEnd at its end.
+    Uint16 mTickOffset;
+};
+
+// Maps keys to game actions and tracks, per tick, for what fraction of the tick each
+// action was held, so movement can respond to presses that land mid-frame.
+class ActionMap {
+public:
+    enum Action {
+        EMoveLeft,
+        EMoveRight,
+        EMoveUp,
+        EMoveDown,
+        ENumActions,
+        ENone = -1
+    };
+
+    ActionMap();
+
+    void Bind(SDL_Scancode scancode, Action action);
+
+    void BeginTick();
+    // Changes must arrive in tick offset order.
+    void ApplyChange(const KeyChange& change);
+    void EndTick();
+
+    bool IsHeld(Action action) const {
+        return mHeldKeys[action] > 0;
+    }
+
+    // Fraction of the last tick, 0 to 1, during which the action was held.
+    float GetHeldFraction(Action action) const {
+        return mHeldTime[action] / static_cast<float>(KeyChange::TickEnd);
+    }
+
+private:
+    Sint8 mBindings[SDL_NUM_SCANCODES];
+    bool mKeyDown[SDL_NUM_SCANCODES];
+
+    int mHeldKeys[ENumActions];
+    Uint32 mHeldSince[ENumActions];
+    Uint32 mHeldTime[ENumActions];
+};
+
+#endif // ACTION_MAP_H
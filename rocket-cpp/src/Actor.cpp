@@ -3,14 +3,16 @@
 #include "Actor.h"
 #include "Component.h"
 #include "Game.h"
+#include "WorldSnapshot.h"
 
 #include <algorithm>
 
 Actor::Actor(Game* game)
-    : mState(EActive)
-    , mPosition(Vector2::Zero)
-    , mScale(1.0f)
-    , mRotation(0.0f)
+    : mId(game->CreateActorId())
+    , mHotStore(&game->GetActorHotStore())
+    , mHandle(mHotStore->Allocate())
+    , mSkippedTime(0.0f)
+    , mUpdatesActor(true)
     , mGame(game) {
     mGame->AddActor(this);
 }
@@ -21,17 +23,27 @@ Actor::~Actor() {
     while (!mComponents.empty()) {
         delete mComponents.back();
     }
+
+    mHotStore->Release(mHandle);
 }
 
 void Actor::Update(float deltaTime) {
-    if (mState == EActive) {
-        UpdateComponents(deltaTime);
+    UpdateComponents(deltaTime);
+    if (mUpdatesActor) {
         UpdateActor(deltaTime);
     }
 }
 
+void Actor::SetState(State state) {
+    int& current = mHotStore->Get(mHandle).mState;
+    if (current != state) {
+        current = state;
+        mGame->ActorStateChanged(this);
+    }
+}
+
 void Actor::UpdateComponents(float deltaTime) {
-    for (auto component : mComponents) {
+    for (auto component : mUpdateComponents) {
         component->Update(deltaTime);
     }
 }
@@ -39,16 +51,28 @@ void Actor::UpdateComponents(float deltaTime) {
 void Actor::UpdateActor(float /* deltaTime */) {
 }
 
-void Actor::AddComponent(Component* component) {
-    int componentOrder = component->GetUpdateOrder();
-    auto iterator = mComponents.begin();
-    for (; iterator != mComponents.end(); ++iterator) {
-        if (componentOrder < (*iterator)->GetUpdateOrder()) {
-            break;
-        }
+void Actor::SaveState(SnapshotWriter& writer) const {
+    writer.Write(mHotStore->Get(mHandle));
+    writer.Write(mSkippedTime);
+
+    // Components are restored in place, so only their per-frame state is stored.
+    for (auto component : mComponents) {
+        component->SaveState(writer);
     }
+}
+
+void Actor::LoadState(SnapshotReader& reader) {
+    reader.Read(mHotStore->Get(mHandle));
+    reader.Read(mSkippedTime);
 
-    mComponents.insert(iterator, component);
+    for (auto component : mComponents) {
+        component->LoadState(reader);
+    }
+}
+
+void Actor::AddComponent(Component* component) {
+    InsertByUpdateOrder(mComponents, component);
+    InsertByUpdateOrder(mUpdateComponents, component);
 }
 
 void Actor::RemoveComponent(Component* component) {
@@ -56,4 +80,27 @@ void Actor::RemoveComponent(Component* component) {
     if (iterator != mComponents.end()) {
         mComponents.erase(iterator);
     }
+
+    SetComponentUpdates(component, false);
+}
+
+void Actor::SetComponentUpdates(Component* component, bool updates) {
+    auto iterator = std::find(mUpdateComponents.begin(), mUpdateComponents.end(), component);
+    if (iterator != mUpdateComponents.end() && !updates) {
+        mUpdateComponents.erase(iterator);
+    } else if (iterator == mUpdateComponents.end() && updates) {
+        InsertByUpdateOrder(mUpdateComponents, component);
+    }
+}
+
+void Actor::InsertByUpdateOrder(ComponentList& components, Component* component) {
+    int componentOrder = component->GetUpdateOrder();
+    auto iterator = components.begin();
+    for (; iterator != components.end(); ++iterator) {
+        if (componentOrder < (*iterator)->GetUpdateOrder()) {
+            break;
+        }
+    }
+
+    components.insert(iterator, component);
 }
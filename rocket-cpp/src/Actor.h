@@ -1,9 +1,22 @@
 #pragma once
 
+#include "ActorHotStore.h"
+#include "Component.h"
 #include "Math.h"
+#include "SDL.h"
+#include "SmallVector.h"
 
 #include <cstdint>
-#include <vector>
+#include <type_traits>
+#include <utility>
+
+// True when T overrides Component::Update somewhere in its hierarchy: taking
+// &T::Update of an inherited function yields a pointer to member of the base.
+template <typename T>
+struct HasComponentUpdate {
+    static_assert(std::is_base_of<Component, T>::value, "T must be a Component");
+    static const bool value = !std::is_same<decltype(&T::Update), decltype(&Component::Update)>::value;
+};
 
 class Actor {
 public:
@@ -16,56 +29,130 @@ public:
     Actor(class Game* game);
     virtual ~Actor();
 
+    // Game only calls this for active actors.
     void Update(float deltaTime);
     void UpdateComponents(float deltaTime);
     virtual void UpdateActor(float deltaTime);
 
-    const Vector2& GetPosition() const {
-        return mPosition;
+    // World snapshots. Subclasses with their own per-frame state extend both, calling the base first.
+    virtual void SaveState(class SnapshotWriter& writer) const;
+    virtual void LoadState(class SnapshotReader& reader);
+
+    // Unique within its Game for the lifetime of the Game; never reused.
+    Uint32 GetId() const {
+        return mId;
+    }
+
+    // By value: the hot store moves when it grows, so a reference would not survive CreateActor.
+    Vector2 GetPosition() const {
+        return mHotStore->Get(mHandle).mPosition;
     }
 
     void SetPosition(const Vector2& pos) {
-        mPosition = pos;
+        mHotStore->Get(mHandle).mPosition = pos;
     }
 
     float GetScale() const {
-        return mScale;
+        return mHotStore->Get(mHandle).mScale;
     }
 
     void SetScale(float scale) {
-        mScale = scale;
+        mHotStore->Get(mHandle).mScale = scale;
     }
 
     float GetRotation() const {
-        return mRotation;
+        return mHotStore->Get(mHandle).mRotation;
     }
 
     void SetRotation(float rotation) {
-        mRotation = rotation;
+        mHotStore->Get(mHandle).mRotation = rotation;
     }
 
     State GetState() const {
-        return mState;
+        return static_cast<State>(mHotStore->Get(mHandle).mState);
     }
 
-    void SetState(State state) {
-        mState = state;
+    // Moves the actor between its game's state partitions; takes effect after the
+    // current update loop when called from inside one.
+    void SetState(State state);
+
+    // Index of this actor's per-frame data in its game's ActorHotStore.
+    Uint32 GetHandle() const {
+        return mHandle;
     }
 
     class Game* GetGame() {
         return mGame;
     }
 
+    // Creates a component owned by this actor. Unlike a plain new, the static type tells
+    // whether it has per-frame work, and components without any are never updated.
+    template <typename T, typename... Args>
+    T* CreateComponent(Args&&... args) {
+        T* component = new T(this, std::forward<Args>(args)...);
+        if (!HasComponentUpdate<T>::value) {
+            SetComponentUpdates(component, false);
+        }
+        return component;
+    }
+
     void AddComponent(class Component* component);
     void RemoveComponent(class Component* component);
 
+    // Components made with new are assumed to need Update until told otherwise.
+    void SetComponentUpdates(class Component* component, bool updates);
+
+    // Whether UpdateActor is called; Game::CreateActor clears it for types that do not override it.
+    void SetActorUpdates(bool updates) {
+        mUpdatesActor = updates;
+    }
+
+    int GetComponentCount() const {
+        return static_cast<int>(mComponents.size());
+    }
+
+    int GetUpdatingComponentCount() const {
+        return static_cast<int>(mUpdateComponents.size());
+    }
+
+    bool HasActorUpdate() const {
+        return mUpdatesActor;
+    }
+
+    // Reduced-rate updates: time of skipped ticks is carried into the next update that runs.
+    void SkipUpdate(float deltaTime) {
+        mSkippedTime += deltaTime;
+    }
+
+    float TakeSkippedTime() {
+        float skipped = mSkippedTime;
+        mSkippedTime = 0.0f;
+        return skipped;
+    }
+
 private:
-    State mState;
+    // Most actors own one to three components, so the lists normally stay inside the Actor.
+    typedef SmallVector<class Component*, 4> ComponentList;
+
+    static void InsertByUpdateOrder(ComponentList& components, class Component* component);
 
-    Vector2 mPosition;
-    float mScale;
-    float mRotation;
+    Uint32 mId;
+    // Position, scale, rotation and state live in the game's hot store.
+    ActorHotStore* mHotStore;
+    Uint32 mHandle;
 
-    std::vector<class Component*> mComponents;
+    float mSkippedTime;
+    bool mUpdatesActor;
+
+    ComponentList mComponents;
+    // The subset of mComponents with per-frame work, also in update order.
+    ComponentList mUpdateComponents;
     class Game* mGame;
 };
+
+// True when T overrides Actor::UpdateActor; see HasComponentUpdate.
+template <typename T>
+struct HasActorUpdate {
+    static_assert(std::is_base_of<Actor, T>::value, "T must be an Actor");
+    static const bool value = !std::is_same<decltype(&T::UpdateActor), decltype(&Actor::UpdateActor)>::value;
+};
@@ -0,0 +1,53 @@
+#include "ActorHotStore.h"
+#include "Actor.h"
+
+#include <cstdint>
+#include <cstring>
+
+ActorHotStore::ActorHotStore()
+    : mData(nullptr)
+    , mCapacity(0)
+    , mCount(0) {
+}
+
+Uint32 ActorHotStore::Allocate() {
+    Uint32 handle;
+    if (!mFreeHandles.empty()) {
+        handle = mFreeHandles.back();
+        mFreeHandles.pop_back();
+    } else {
+        if (mCount == mCapacity) {
+            Grow();
+        }
+        handle = mCount++;
+    }
+
+    ActorHotData& data = mData[handle];
+    data.mPosition = Vector2::Zero;
+    data.mScale = 1.0f;
+    data.mRotation = 0.0f;
+    data.mState = Actor::EActive;
+    return handle;
+}
+
+void ActorHotStore::Release(Uint32 handle) {
+    mData[handle].mState = Actor::EDead;
+    mFreeHandles.emplace_back(handle);
+}
+
+void ActorHotStore::Grow() {
+    Uint32 capacity = mCapacity > 0 ? mCapacity * 2 : 256;
+
+    std::vector<Uint8> storage(capacity * sizeof(ActorHotData) + CacheLine);
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage.data());
+    std::uintptr_t aligned = (address + CacheLine - 1) & ~static_cast<std::uintptr_t>(CacheLine - 1);
+    ActorHotData* data = reinterpret_cast<ActorHotData*>(aligned);
+
+    if (mCount > 0) {
+        std::memcpy(data, mData, mCount * sizeof(ActorHotData));
+    }
+
+    mStorage.swap(storage);
+    mData = data;
+    mCapacity = capacity;
+}
@@ -0,0 +1,59 @@
+#ifndef ACTOR_HOT_STORE_H
+#define ACTOR_HOT_STORE_H
+
+#include "Math.h"
+#include "SDL.h"
+
+#include <vector>
+
+// Fields of an Actor touched every frame, kept out of the Actor object so loops
+// over many actors stream through one array instead of chasing heap pointers.
+struct ActorHotData {
+    Vector2 mPosition;
+    float mScale;
+    float mRotation;
+    // Actor::State.
+    int mState;
+};
+
+// Contiguous, cache-line aligned array of ActorHotData owned by a Game and
+// indexed by actor handle. Released handles are reused by later actors.
+class ActorHotStore {
+public:
+    ActorHotStore();
+
+    // Returns a handle whose data is reset to the Actor defaults.
+    Uint32 Allocate();
+    void Release(Uint32 handle);
+
+    ActorHotData& Get(Uint32 handle) {
+        return mData[handle];
+    }
+
+    const ActorHotData& Get(Uint32 handle) const {
+        return mData[handle];
+    }
+
+    // Data for handles [0, GetHandleCount()); released handles in that range hold stale values.
+    const ActorHotData* GetData() const {
+        return mData;
+    }
+
+    Uint32 GetHandleCount() const {
+        return mCount;
+    }
+
+private:
+    static const std::size_t CacheLine = 64;
+
+    void Grow();
+
+    // Over-allocated by a cache line so mData can start on a line boundary.
+    std::vector<Uint8> mStorage;
+    ActorHotData* mData;
+    Uint32 mCapacity;
+    Uint32 mCount;
+    std::vector<Uint32> mFreeHandles;
+};
+
+#endif // ACTOR_HOT_STORE_H
@@ -0,0 +1,12 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+namespace AllocationCounter {
+
+// Number of global operator new calls made by the calling thread.
+std::uint64_t GetCount();
+} // namespace AllocationCounter
+
+#endif // ALLOCATION_COUNTER_H
@@ -1,31 +1,67 @@
-#include "Math.h"
 #include "AnimatedSpriteComponent.h"
+#include "Actor.h"
+#include "AnimationClip.h"
+#include "Game.h"
+#include "WorldSnapshot.h"
 
 AnimatedSpriteComponent::AnimatedSpriteComponent(Actor* owner, int drawOrder)
     : SpriteComponent(owner, drawOrder)
+    , mClip(nullptr)
     , mCurrentFrame(0.0f)
-    , mAnimationFPS(24.0f) {
+    , mFrameIndex(0)
+    , mAnimationFPS(24.0f)
+    , mSinceFrameChange(0.0f) {
 }
 
 void AnimatedSpriteComponent::Update(float deltaTime) {
     SpriteComponent::Update(deltaTime);
 
-    if (mAnimationTextures.size() > 0) {
-        mCurrentFrame += mAnimationFPS * deltaTime;
+    if (mClip && mClip->GetFrameCount() > 0) {
+        mCurrentFrame = mClip->WrapPosition(mCurrentFrame + mAnimationFPS * deltaTime);
 
-        while (mCurrentFrame >= mAnimationTextures.size()) {
-            mCurrentFrame -= mAnimationTextures.size();
-        }
+        int frameIndex = mClip->GetFrameIndex(mCurrentFrame);
+        mSinceFrameChange += deltaTime;
+
+        // At reduced quality frames are held longer; playback speed is unchanged.
+        float rate = mOwner->GetGame()->GetQuality().mAnimationRate;
+        if (frameIndex != mFrameIndex && (rate >= 1.0f || mSinceFrameChange * mAnimationFPS * rate >= 1.0f)) {
+            mFrameIndex = frameIndex;
+            mSinceFrameChange = 0.0f;
 
-        SetTexture(mAnimationTextures[static_cast<unsigned int>(mCurrentFrame)]);
+            const AnimationClip::Frame& frame = mClip->GetFrame(frameIndex);
+            SetTextureRegion(frame.mTexture, frame.mSource);
+        }
     }
 }
 
-void AnimatedSpriteComponent::SetAnimationTextures(const std::vector<SDL_Texture*>& textures) {
-    mAnimationTextures = textures;
+void AnimatedSpriteComponent::SetAnimationClip(const AnimationClip* clip) {
+    mClip = clip;
+    mCurrentFrame = 0.0f;
+    mFrameIndex = 0;
+    mSinceFrameChange = 0.0f;
+
+    if (mClip && mClip->GetFrameCount() > 0) {
+        mAnimationFPS = mClip->GetFPS();
 
-    if (mAnimationTextures.size() > 0) {
-        mCurrentFrame = 0.0f;
-        SetTexture(mAnimationTextures[0]);
+        const AnimationClip::Frame& frame = mClip->GetFrame(0);
+        SetTextureRegion(frame.mTexture, frame.mSource);
     }
 }
+
+void AnimatedSpriteComponent::SaveState(SnapshotWriter& writer) const {
+    SpriteComponent::SaveState(writer);
+    writer.Write(mClip);
+    writer.Write(mCurrentFrame);
+    writer.Write(mFrameIndex);
+    writer.Write(mAnimationFPS);
+    writer.Write(mSinceFrameChange);
+}
+
+void AnimatedSpriteComponent::LoadState(SnapshotReader& reader) {
+    SpriteComponent::LoadState(reader);
+    reader.Read(mClip);
+    reader.Read(mCurrentFrame);
+    reader.Read(mFrameIndex);
+    reader.Read(mAnimationFPS);
+    reader.Read(mSinceFrameChange);
+}
@@ -3,14 +3,18 @@
 
 #include "SpriteComponent.h"
 
-#include <vector>
-
 class AnimatedSpriteComponent : public SpriteComponent {
 public:
     AnimatedSpriteComponent(class Actor* owner, int drawOrder = 100);
 
     void Update(float deltaTime) override;
-    void SetAnimationTextures(const std::vector<SDL_Texture*>& textures);
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+    void SetAnimationClip(const class AnimationClip* clip);
+
+    const class AnimationClip* GetAnimationClip() const {
+        return mClip;
+    }
 
     float GetAnimationFPS() const {
         return mAnimationFPS;
@@ -21,9 +25,11 @@ public:
     }
 
 private:
-    std::vector<SDL_Texture*> mAnimationTextures;
+    const class AnimationClip* mClip;
     float mCurrentFrame;
+    int mFrameIndex;
     float mAnimationFPS;
+    float mSinceFrameChange;
 };
 
 #endif // ANIMATED_SPRITE_COMPONENT_H
@@ -0,0 +1,58 @@
+#include "AnimationClip.h"
+#include "Math.h"
+
+AnimationClip::AnimationClip(const std::vector<SDL_Texture*>& textures, float fps, LoopMode loopMode)
+    : mFPS(fps)
+    , mLoopMode(loopMode) {
+    mFrames.reserve(textures.size());
+    for (auto texture : textures) {
+        Frame frame;
+        frame.mTexture = texture;
+        frame.mSource.x = 0;
+        frame.mSource.y = 0;
+        frame.mSource.w = 0;
+        frame.mSource.h = 0;
+        SDL_QueryTexture(texture, nullptr, nullptr, &frame.mSource.w, &frame.mSource.h);
+        mFrames.emplace_back(frame);
+    }
+}
+
+AnimationClip::AnimationClip(SDL_Texture* sheet, const std::vector<SDL_Rect>& frames, float fps, LoopMode loopMode)
+    : mFPS(fps)
+    , mLoopMode(loopMode) {
+    mFrames.reserve(frames.size());
+    for (const auto& source : frames) {
+        Frame frame;
+        frame.mTexture = sheet;
+        frame.mSource = source;
+        mFrames.emplace_back(frame);
+    }
+}
+
+float AnimationClip::WrapPosition(float position) const {
+    float count = static_cast<float>(mFrames.size());
+    if (count <= 1.0f) {
+        return 0.0f;
+    }
+
+    switch (mLoopMode) {
+        case EOnce:
+            return Math::Min(position, count - 1.0f);
+        case EPingPong:
+            return Math::Fmod(position, 2.0f * count - 2.0f);
+        case ELoop:
+        default:
+            return Math::Fmod(position, count);
+    }
+}
+
+int AnimationClip::GetFrameIndex(float position) const {
+    int count = static_cast<int>(mFrames.size());
+    int index = static_cast<int>(position);
+
+    if (mLoopMode == EPingPong && index >= count) {
+        index = 2 * count - 2 - index;
+    }
+
+    return Math::Clamp(index, 0, count - 1);
+}
@@ -0,0 +1,55 @@
+#ifndef ANIMATION_CLIP_H
+#define ANIMATION_CLIP_H
+
+#include "SDL.h"
+#include "SmallVector.h"
+
+#include <vector>
+
+// Immutable animation resource shared by any number of AnimatedSpriteComponents.
+// A frame is a source rectangle within a texture: either a whole texture per frame
+// or cells of one sprite sheet. Frame sizes are resolved once when the clip is built.
+class AnimationClip {
+public:
+    enum LoopMode {
+        ELoop,
+        EOnce,
+        EPingPong
+    };
+
+    struct Frame {
+        SDL_Texture* mTexture;
+        SDL_Rect mSource;
+    };
+
+    AnimationClip(const std::vector<SDL_Texture*>& textures, float fps, LoopMode loopMode = ELoop);
+    AnimationClip(SDL_Texture* sheet, const std::vector<SDL_Rect>& frames, float fps, LoopMode loopMode = ELoop);
+
+    // Wraps or clamps a playback position (in frames) according to the loop mode.
+    float WrapPosition(float position) const;
+    int GetFrameIndex(float position) const;
+
+    int GetFrameCount() const {
+        return static_cast<int>(mFrames.size());
+    }
+
+    const Frame& GetFrame(int index) const {
+        return mFrames[index];
+    }
+
+    float GetFPS() const {
+        return mFPS;
+    }
+
+    LoopMode GetLoopMode() const {
+        return mLoopMode;
+    }
+
+private:
+    // Sprite animations here are a few frames long; the GetFrame lookup stays inside the clip.
+    SmallVector<Frame, 4> mFrames;
+    float mFPS;
+    LoopMode mLoopMode;
+};
+
+#endif // ANIMATION_CLIP_H
@@ -0,0 +1,368 @@
+#include "AudioSystem.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_USE_SSE2 1
+#endif
+
+namespace {
+    // 5.3 ms at 48 kHz; small enough to keep effects tight to the frame that triggered them.
+    const Uint16 DeviceBufferFrames = 256;
+    const int DeviceSampleRate = 48000;
+
+    // destination += source * gain for interleaved stereo samples.
+    void AddScaled(float* destination, const float* source, int samples, float gainLeft, float gainRight) {
+        int i = 0;
+#ifdef AUDIO_USE_SSE2
+        // Two interleaved stereo frames per register.
+        __m128 gain = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+        for (; i + 4 <= samples; i += 4) {
+            __m128 mixed = _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), gain));
+            _mm_storeu_ps(destination + i, mixed);
+        }
+#endif
+        for (; i < samples; i += 2) {
+            destination[i] += source[i] * gainLeft;
+            destination[i + 1] += source[i + 1] * gainRight;
+        }
+    }
+}
+
+AudioSystem::AudioSystem()
+    : mDevice(0)
+    , mNextPlayId(1)
+    , mMasterVolume(1.0f)
+    , mMusic(nullptr)
+    , mMusicVolume(1.0f)
+    , mCallbackTicks(0)
+    , mCallbackMaxTicks(0)
+    , mCallbackCount(0)
+    , mActiveVoices(0) {
+    SDL_zero(mSpec);
+    for (Voice& voice : mVoices) {
+        voice = Voice();
+    }
+}
+
+AudioSystem::~AudioSystem() {
+    Shutdown();
+}
+
+bool AudioSystem::Initialize() {
+    SDL_AudioSpec desired;
+    SDL_zero(desired);
+    desired.freq = DeviceSampleRate;
+    desired.format = AUDIO_F32SYS;
+    desired.channels = Channels;
+    desired.samples = DeviceBufferFrames;
+    desired.callback = AudioCallback;
+    desired.userdata = this;
+
+    // Only the rate may differ; SDL converts anything else so the mixer always sees stereo floats.
+    mDevice = SDL_OpenAudioDevice(nullptr, 0, &desired, &mSpec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (mDevice == 0) {
+        SDL_Log("Failed to open audio device: %s", SDL_GetError());
+        return false;
+    }
+
+    mMusicScratch.resize(mSpec.samples * Channels);
+
+    SDL_PauseAudioDevice(mDevice, 0);
+    return true;
+}
+
+void AudioSystem::Shutdown() {
+    if (mDevice != 0) {
+        SDL_CloseAudioDevice(mDevice);
+        mDevice = 0;
+    }
+
+    delete mMusic;
+    mMusic = nullptr;
+
+    for (auto& sound : mSounds) {
+        delete sound.second;
+    }
+    mSounds.clear();
+}
+
+const Sound* AudioSystem::GetSound(const std::string& fileName) {
+    auto iter = mSounds.find(fileName);
+    if (iter != mSounds.end()) {
+        return iter->second;
+    }
+
+    if (mDevice == 0) {
+        return nullptr;
+    }
+
+    SDL_AudioSpec wavSpec;
+    Uint8* wavBuffer = nullptr;
+    Uint32 wavLength = 0;
+    if (!SDL_LoadWAV(fileName.c_str(), &wavSpec, &wavBuffer, &wavLength)) {
+        SDL_Log("Failed to load sound %s: %s", fileName.c_str(), SDL_GetError());
+        return nullptr;
+    }
+
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, wavSpec.format, wavSpec.channels, wavSpec.freq,
+                          AUDIO_F32SYS, Channels, mSpec.freq) < 0) {
+        SDL_Log("Failed to convert sound %s: %s", fileName.c_str(), SDL_GetError());
+        SDL_FreeWAV(wavBuffer);
+        return nullptr;
+    }
+
+    std::vector<Uint8> buffer(static_cast<size_t>(wavLength) * std::max(cvt.len_mult, 1));
+    std::copy(wavBuffer, wavBuffer + wavLength, buffer.begin());
+    SDL_FreeWAV(wavBuffer);
+
+    cvt.buf = buffer.data();
+    cvt.len = static_cast<int>(wavLength);
+    if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) {
+        SDL_Log("Failed to convert sound %s: %s", fileName.c_str(), SDL_GetError());
+        return nullptr;
+    }
+
+    int bytes = cvt.needed ? cvt.len_cvt : cvt.len;
+    Sound* sound = new Sound();
+    sound->mFrames = static_cast<Uint32>(bytes / (sizeof(float) * Channels));
+    sound->mSamples.resize(sound->mFrames * Channels);
+    SDL_memcpy(sound->mSamples.data(), buffer.data(), sound->mFrames * Channels * sizeof(float));
+
+    mSounds.emplace(fileName, sound);
+    return sound;
+}
+
+Uint32 AudioSystem::Play(const Sound* sound, float volume, float pan, bool loop) {
+    if (!sound || sound->mFrames == 0) {
+        return 0;
+    }
+
+    Command command;
+    command.mType = Command::EPlay;
+    command.mPlayId = mNextPlayId++;
+    command.mSound = sound;
+    command.mVolume = volume;
+    command.mPan = pan;
+    command.mLoop = loop;
+
+    if (mNextPlayId == 0) {
+        mNextPlayId = 1;
+    }
+
+    return mCommands.Push(command) ? command.mPlayId : 0;
+}
+
+void AudioSystem::Stop(Uint32 playId) {
+    Command command = Command();
+    command.mType = Command::EStop;
+    command.mPlayId = playId;
+    mCommands.Push(command);
+}
+
+void AudioSystem::SetVolume(Uint32 playId, float volume, float pan) {
+    Command command = Command();
+    command.mType = Command::EVolume;
+    command.mPlayId = playId;
+    command.mVolume = volume;
+    command.mPan = pan;
+    mCommands.Push(command);
+}
+
+void AudioSystem::SetMasterVolume(float volume) {
+    Command command = Command();
+    command.mType = Command::EMasterVolume;
+    command.mVolume = volume;
+    mCommands.Push(command);
+}
+
+bool AudioSystem::PlayMusic(const std::string& fileName, int bufferMs, bool loop, float volume) {
+    if (mDevice == 0) {
+        return false;
+    }
+
+    // Opening only parses the header; the worker thread decodes ahead from here on.
+    MusicStream* music = new MusicStream(mSpec.freq, bufferMs);
+    if (!music->Open(fileName, loop)) {
+        delete music;
+        return false;
+    }
+
+    SDL_LockAudioDevice(mDevice);
+    MusicStream* previous = mMusic;
+    mMusic = music;
+    mMusicVolume = volume;
+    SDL_UnlockAudioDevice(mDevice);
+
+    delete previous;
+    return true;
+}
+
+void AudioSystem::StopMusic() {
+    if (!mMusic) {
+        return;
+    }
+
+    SDL_LockAudioDevice(mDevice);
+    MusicStream* previous = mMusic;
+    mMusic = nullptr;
+    SDL_UnlockAudioDevice(mDevice);
+
+    delete previous;
+}
+
+AudioSystem::CallbackStats AudioSystem::ConsumeCallbackStats() {
+    CallbackStats stats;
+    double ticksToMs = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+
+    Uint32 count = mCallbackCount.exchange(0, std::memory_order_relaxed);
+    Uint64 ticks = mCallbackTicks.exchange(0, std::memory_order_relaxed);
+    Uint64 maxTicks = mCallbackMaxTicks.exchange(0, std::memory_order_relaxed);
+
+    stats.mCallbacks = count;
+    stats.mAverageMs = count > 0 ? static_cast<float>(ticks * ticksToMs / count) : 0.0f;
+    stats.mMaxMs = static_cast<float>(maxTicks * ticksToMs);
+    stats.mBudgetMs = mSpec.freq > 0 ? 1000.0f * mSpec.samples / mSpec.freq : 0.0f;
+    stats.mActiveVoices = mActiveVoices.load(std::memory_order_relaxed);
+    stats.mMusicBufferedMs = mMusic ? mMusic->GetBufferedMs() : 0.0f;
+    stats.mMusicUnderruns = mMusic ? mMusic->GetUnderruns() : 0;
+
+    return stats;
+}
+
+void SDLCALL AudioSystem::AudioCallback(void* userdata, Uint8* stream, int len) {
+    AudioSystem* audio = static_cast<AudioSystem*>(userdata);
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    audio->Mix(reinterpret_cast<float*>(stream), len / static_cast<int>(sizeof(float) * Channels));
+
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    audio->mCallbackTicks.fetch_add(elapsed, std::memory_order_relaxed);
+    audio->mCallbackCount.fetch_add(1, std::memory_order_relaxed);
+
+    Uint64 previousMax = audio->mCallbackMaxTicks.load(std::memory_order_relaxed);
+    while (elapsed > previousMax &&
+           !audio->mCallbackMaxTicks.compare_exchange_weak(previousMax, elapsed, std::memory_order_relaxed)) {
+    }
+}
+
+void AudioSystem::ApplyCommands() {
+    Command command;
+    while (mCommands.Pop(command)) {
+        switch (command.mType) {
+            case Command::EPlay:
+            case Command::EVolume: {
+                Voice* target = nullptr;
+                for (Voice& voice : mVoices) {
+                    if (command.mType == Command::EPlay ? !voice.mSound : voice.mPlayId == command.mPlayId) {
+                        target = &voice;
+                        break;
+                    }
+                }
+                if (!target) {
+                    break;
+                }
+
+                if (command.mType == Command::EPlay) {
+                    target->mSound = command.mSound;
+                    target->mPlayId = command.mPlayId;
+                    target->mPosition = 0;
+                    target->mLoop = command.mLoop;
+                }
+
+                float pan = std::min(std::max(command.mPan, -1.0f), 1.0f);
+                target->mGainLeft = command.mVolume * std::min(1.0f, 1.0f - pan);
+                target->mGainRight = command.mVolume * std::min(1.0f, 1.0f + pan);
+                break;
+            }
+            case Command::EStop:
+                for (Voice& voice : mVoices) {
+                    if (voice.mSound && voice.mPlayId == command.mPlayId) {
+                        voice = Voice();
+                    }
+                }
+                break;
+            case Command::EMasterVolume:
+                mMasterVolume = command.mVolume;
+                break;
+        }
+    }
+}
+
+void AudioSystem::Mix(float* out, int frames) {
+    ApplyCommands();
+
+    int samples = frames * Channels;
+    std::fill(out, out + samples, 0.0f);
+
+    int active = 0;
+    for (Voice& voice : mVoices) {
+        if (voice.mSound) {
+            MixVoice(voice, out, frames);
+            ++active;
+        }
+    }
+    mActiveVoices.store(active, std::memory_order_relaxed);
+
+    if (mMusic) {
+        MixMusic(out, frames);
+    }
+
+    int i = 0;
+#ifdef AUDIO_USE_SSE2
+    __m128 master = _mm_set1_ps(mMasterVolume);
+    __m128 low = _mm_set1_ps(-1.0f);
+    __m128 high = _mm_set1_ps(1.0f);
+    for (; i + 4 <= samples; i += 4) {
+        __m128 value = _mm_mul_ps(_mm_loadu_ps(out + i), master);
+        _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(value, low), high));
+    }
+#endif
+    for (; i < samples; ++i) {
+        out[i] = std::min(std::max(out[i] * mMasterVolume, -1.0f), 1.0f);
+    }
+}
+
+void AudioSystem::MixVoice(Voice& voice, float* out, int frames) {
+    const Sound* sound = voice.mSound;
+    int written = 0;
+
+    while (written < frames) {
+        int count = std::min(frames - written, static_cast<int>(sound->mFrames - voice.mPosition));
+        const float* source = sound->mSamples.data() + voice.mPosition * Channels;
+        float* destination = out + written * Channels;
+        int samples = count * Channels;
+
+        AddScaled(destination, source, samples, voice.mGainLeft, voice.mGainRight);
+
+        written += count;
+        voice.mPosition += count;
+
+        if (voice.mPosition >= sound->mFrames) {
+            if (!voice.mLoop) {
+                voice = Voice();
+                return;
+            }
+            voice.mPosition = 0;
+        }
+    }
+}
+
+void AudioSystem::MixMusic(float* out, int frames) {
+    int chunkFrames = static_cast<int>(mMusicScratch.size()) / Channels;
+
+    for (int written = 0; written < frames;) {
+        int requested = std::min(chunkFrames, frames - written);
+        int count = mMusic->Read(mMusicScratch.data(), requested);
+
+        AddScaled(out + written * Channels, mMusicScratch.data(), count * Channels, mMusicVolume, mMusicVolume);
+        written += count;
+
+        // The ring is drained; reading again would count the same underrun twice.
+        if (count < requested) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef AUDIO_SYSTEM_H
+#define AUDIO_SYSTEM_H
+
+#include "MusicStream.h"
+#include "SDL.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Sound effect decoded once into the device format: interleaved stereo floats.
+struct Sound {
+    std::vector<float> mSamples;
+    Uint32 mFrames;
+};
+
+// Mixes a fixed pool of voices in the SDL audio callback. The game thread only
+// sends commands through a lock-free queue; the callback never locks or allocates.
+class AudioSystem {
+public:
+    static const int MaxVoices = 32;
+    static const int Channels = 2;
+
+    AudioSystem();
+    ~AudioSystem();
+
+    bool Initialize();
+    void Shutdown();
+
+    const Sound* GetSound(const std::string& fileName);
+
+    // Returns an id for Stop/SetVolume, or zero if the command queue is full.
+    // When every voice is busy the sound is dropped by the mixer.
+    Uint32 Play(const Sound* sound, float volume = 1.0f, float pan = 0.0f, bool loop = false);
+    void Stop(Uint32 playId);
+    void SetVolume(Uint32 playId, float volume, float pan = 0.0f);
+    void SetMasterVolume(float volume);
+
+    // Streams a WAV track from disk, replacing the current one. bufferMs sets the decode-ahead depth.
+    bool PlayMusic(const std::string& fileName, int bufferMs, bool loop = true, float volume = 1.0f);
+    void StopMusic();
+
+    bool IsOpen() const {
+        return mDevice != 0;
+    }
+
+    int GetSampleRate() const {
+        return mSpec.freq;
+    }
+
+    struct CallbackStats {
+        float mAverageMs;
+        float mMaxMs;
+        // Audio duration each callback has to fill; exceeding it means an underrun.
+        float mBudgetMs;
+        Uint32 mCallbacks;
+        int mActiveVoices;
+        float mMusicBufferedMs;
+        Uint32 mMusicUnderruns;
+    };
+
+    // Timing since the previous call, measured inside the audio callback.
+    CallbackStats ConsumeCallbackStats();
+
+private:
+    struct Command {
+        enum Type {
+            EPlay,
+            EStop,
+            EVolume,
+            EMasterVolume
+        };
+
+        Type mType;
+        Uint32 mPlayId;
+        const Sound* mSound;
+        float mVolume;
+        float mPan;
+        bool mLoop;
+    };
+
+    struct Voice {
+        const Sound* mSound;
+        Uint32 mPlayId;
+        Uint32 mPosition;
+        float mGainLeft;
+        float mGainRight;
+        bool mLoop;
+    };
+
+    static void SDLCALL AudioCallback(void* userdata, Uint8* stream, int len);
+
+    void Mix(float* out, int frames);
+    void ApplyCommands();
+    void MixVoice(Voice& voice, float* out, int frames);
+    void MixMusic(float* out, int frames);
+
+    SDL_AudioDeviceID mDevice;
+    SDL_AudioSpec mSpec;
+
+    std::unordered_map<std::string, Sound*> mSounds;
+    Uint32 mNextPlayId;
+
+    SpscQueue<Command, 256> mCommands;
+
+    // Owned by the audio callback.
+    Voice mVoices[MaxVoices];
+    float mMasterVolume;
+
+    // Swapped by the game thread only while the device is locked.
+    MusicStream* mMusic;
+    float mMusicVolume;
+    std::vector<float> mMusicScratch;
+
+    std::atomic<Uint64> mCallbackTicks;
+    std::atomic<Uint64> mCallbackMaxTicks;
+    std::atomic<Uint32> mCallbackCount;
+    std::atomic<int> mActiveVoices;
+};
+
+#endif // AUDIO_SYSTEM_H
@@ -1,44 +1,134 @@
 #include "BackgroundSpriteComponent.h"
 #include "Actor.h"
+#include "Game.h"
+#include "WorldSnapshot.h"
+
+namespace {
+
+float Wrap(float value, float length) {
+    if (length <= 0.0f) {
+        return 0.0f;
+    }
+
+    value = Math::Fmod(value, length);
+    return value < 0.0f ? value + length : value;
+}
+} // namespace
 
 BackgroundSpriteComponent::BackgroundSpriteComponent(Actor* owner, int drawOrder)
     : SpriteComponent(owner, drawOrder)
-    , mScrollSpeed(0.0f) {
+    , mLayout(EHorizontal)
+    , mLayerRank(0)
+    , mPixelsWritten(0) {
 }
 
 void BackgroundSpriteComponent::Update(float deltaTime) {
     SpriteComponent::Update(deltaTime);
 
-    for (auto& bg : mBackgroundTextures) {
-        bg.mOffset.x += mScrollSpeed * deltaTime;
+    float count = static_cast<float>(mBackgroundTextures.size());
+    float stripX = mLayout == EHorizontal ? count * mScreenSize.x : mScreenSize.x;
+    float stripY = mLayout == EVertical ? count * mScreenSize.y : mScreenSize.y;
 
-        if (bg.mOffset.x < -mScreenSize.x) {
-            bg.mOffset.x = (mBackgroundTextures.size() - 1) * mScreenSize.x - 1;
-        }
-    }
+    // Scrolling content left moves the view right through the strip.
+    mScroll.x = Wrap(mScroll.x - mScrollVelocity.x * deltaTime, stripX);
+    mScroll.y = Wrap(mScroll.y - mScrollVelocity.y * deltaTime, stripY);
+}
+
+void BackgroundSpriteComponent::SaveState(SnapshotWriter& writer) const {
+    SpriteComponent::SaveState(writer);
+    writer.Write(mScroll);
+    writer.Write(mScrollVelocity);
+}
+
+void BackgroundSpriteComponent::LoadState(SnapshotReader& reader) {
+    SpriteComponent::LoadState(reader);
+    reader.Read(mScroll);
+    reader.Read(mScrollVelocity);
 }
 
 void BackgroundSpriteComponent::Draw(SDL_Renderer* renderer) {
-    for (auto& bg : mBackgroundTextures) {
-        SDL_Rect r;
+    mPixelsWritten = 0;
+
+    if (mBackgroundTextures.empty() || mLayerRank >= mOwner->GetGame()->GetQuality().mBackgroundLayers) {
+        return;
+    }
+
+    int count = static_cast<int>(mBackgroundTextures.size());
+    int tileW = static_cast<int>(mScreenSize.x);
+    int tileH = static_cast<int>(mScreenSize.y);
+    if (tileW <= 0 || tileH <= 0) {
+        return;
+    }
+
+    int originX = static_cast<int>(mOwner->GetPosition().x - tileW / 2);
+    int originY = static_cast<int>(mOwner->GetPosition().y - tileH / 2);
+
+    // The view spans at most two tiles along each axis. Along the layout axis
+    // the second one is the next tile in the strip; across it the same tile
+    // repeats.
+    int scrollX = static_cast<int>(mScroll.x);
+    int scrollY = static_cast<int>(mScroll.y);
+
+    int firstX = scrollX / tileW;
+    int firstY = scrollY / tileH;
+    int offsetX = scrollX - firstX * tileW;
+    int offsetY = scrollY - firstY * tileH;
+
+    for (int row = 0; row < 2; ++row) {
+        int tileY = row == 0 ? offsetY : 0;
+        int height = row == 0 ? tileH - offsetY : offsetY;
+        int dstY = row == 0 ? 0 : tileH - offsetY;
+        if (height <= 0) {
+            continue;
+        }
+
+        for (int column = 0; column < 2; ++column) {
+            int tileX = column == 0 ? offsetX : 0;
+            int width = column == 0 ? tileW - offsetX : offsetX;
+            int dstX = column == 0 ? 0 : tileW - offsetX;
+            if (width <= 0) {
+                continue;
+            }
 
-        r.w = static_cast<int>(mScreenSize.x);
-        r.h = static_cast<int>(mScreenSize.y);
-        r.x = static_cast<int>(mOwner->GetPosition().x - r.w / 2 + bg.mOffset.x);
-        r.y = static_cast<int>(mOwner->GetPosition().y - r.h / 2 + bg.mOffset.y);
+            int index = mLayout == EHorizontal ? firstX + column : firstY + row;
+            const BackgroundTexture& bg = mBackgroundTextures[index % count];
 
-        SDL_RenderCopy(renderer, bg.mTexture, nullptr, &r);
+            DrawSlice(renderer, bg, tileX, tileY, width, height, originX + dstX, originY + dstY);
+        }
     }
+
+    mOwner->GetGame()->GetStats().AddFill(GetDrawOrder(), mPixelsWritten);
+}
+
+void BackgroundSpriteComponent::DrawSlice(SDL_Renderer* renderer, const BackgroundTexture& bg, int tileX, int tileY, int tileW, int tileH, int dstX, int dstY) {
+    // Tiles are stretched to the screen size, so map the slice back to texels.
+    float scaleX = bg.mWidth / mScreenSize.x;
+    float scaleY = bg.mHeight / mScreenSize.y;
+
+    SDL_Rect src;
+    src.x = static_cast<int>(tileX * scaleX);
+    src.y = static_cast<int>(tileY * scaleY);
+    src.w = Math::Max(static_cast<int>((tileX + tileW) * scaleX) - src.x, 1);
+    src.h = Math::Max(static_cast<int>((tileY + tileH) * scaleY) - src.y, 1);
+
+    SDL_Rect dst;
+    dst.x = dstX;
+    dst.y = dstY;
+    dst.w = tileW;
+    dst.h = tileH;
+
+    SDL_RenderCopy(renderer, bg.mTexture, &src, &dst);
+    mPixelsWritten += tileW * tileH;
 }
 
 void BackgroundSpriteComponent::SetBackgroundTextures(const std::vector<SDL_Texture*>& textures) {
-    int count = 0;
+    mBackgroundTextures.reserve(mBackgroundTextures.size() + textures.size());
     for (auto texture : textures) {
         BackgroundTexture temp;
         temp.mTexture = texture;
-        temp.mOffset.x = count * mScreenSize.x;
-        temp.mOffset.y = 0;
+        temp.mWidth = 0;
+        temp.mHeight = 0;
+        SDL_QueryTexture(texture, nullptr, nullptr, &temp.mWidth, &temp.mHeight);
         mBackgroundTextures.emplace_back(temp);
-        ++count;
     }
 }
@@ -2,16 +2,27 @@
 #define BACKGROUND_SPRITE_COMPONENT_H
 
 #include "Math.h"
+#include "SmallVector.h"
 #include "SpriteComponent.h"
 
 #include <vector>
 
+// Parallax layer made of screen-sized tiles placed end to end along one axis.
+// The strip wraps along that axis and each tile repeats along the other, so
+// the layer can scroll in any direction with any number of tiles.
 class BackgroundSpriteComponent : public SpriteComponent {
 public:
+    enum Layout {
+        EHorizontal,
+        EVertical
+    };
+
     BackgroundSpriteComponent(class Actor* owner, int drawOrder = 10);
 
     void Update(float deltaTime) override;
     void Draw(SDL_Renderer* renderer) override;
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
 
     void SetBackgroundTextures(const std::vector<SDL_Texture*>& textures);
 
@@ -19,23 +30,56 @@ public:
         mScreenSize = size;
     }
 
+    void SetLayout(Layout layout) {
+        mLayout = layout;
+    }
+
+    // Horizontal scroll speed in pixels per second; kept for existing callers.
     void SetScrollSpeed(float speed) {
-        mScrollSpeed = speed;
+        mScrollVelocity = Vector2(speed, 0.0f);
     }
 
     float GetScrollSpeed() const {
-        return mScrollSpeed;
+        return mScrollVelocity.x;
+    }
+
+    void SetScrollVelocity(const Vector2& velocity) {
+        mScrollVelocity = velocity;
+    }
+
+    const Vector2& GetScrollVelocity() const {
+        return mScrollVelocity;
+    }
+
+    // Layers of rank 0 always draw; higher ranks are dropped first by the quality governor.
+    void SetLayerRank(int rank) {
+        mLayerRank = rank;
+    }
+
+    // Destination pixels covered by the last Draw.
+    int GetPixelsWritten() const {
+        return mPixelsWritten;
     }
 
 private:
     struct BackgroundTexture {
         SDL_Texture* mTexture;
-        Vector2 mOffset;
+        int mWidth;
+        int mHeight;
     };
 
-    std::vector<BackgroundTexture> mBackgroundTextures;
+    void DrawSlice(SDL_Renderer* renderer, const BackgroundTexture& bg, int tileX, int tileY, int tileW, int tileH, int dstX, int dstY);
+
+    // Layers are usually a pair of tiles, kept inside the component.
+    SmallVector<BackgroundTexture, 2> mBackgroundTextures;
     Vector2 mScreenSize;
-    float mScrollSpeed;
+    Vector2 mScrollVelocity;
+    // Position of the view within the layer, wrapped to [0, strip length) along
+    // the layout axis and [0, tile size) across it.
+    Vector2 mScroll;
+    Layout mLayout;
+    int mLayerRank;
+    int mPixelsWritten;
 };
 
 #endif // BACKGROUND_SPRITE_COMPONENT_H
@@ -13,3 +13,9 @@ Component::~Component() {
 
 void Component::Update(float deltaTime) {
 }
+
+void Component::SaveState(SnapshotWriter& /* writer */) const {
+}
+
+void Component::LoadState(SnapshotReader& /* reader */) {
+}
@@ -7,6 +7,10 @@ public:
 
     virtual void Update(float deltaTime);
 
+    // Per-frame state for world snapshots; configuration set at load time is not included.
+    virtual void SaveState(class SnapshotWriter& writer) const;
+    virtual void LoadState(class SnapshotReader& reader);
+
     int GetUpdateOrder() const {
         return mUpdateOrder;
     }
@@ -0,0 +1,68 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float Smoothing = 0.1f;
+    // Grow only below this fraction of the budget, so the scale does not oscillate around it.
+    const float GrowThreshold = 0.75f;
+    const int GrowAfterFrames = 30;
+    const int CooldownFrames = 10;
+    const float GrowStep = 0.05f;
+    // Scales are kept on a coarse grid so small changes do not resample every frame.
+    const float ScaleQuantum = 0.025f;
+}
+
+DynamicResolution::DynamicResolution()
+    : mMinScale(0.5f)
+    , mMaxScale(1.0f)
+    , mBudgetMs(8.0f)
+    , mScale(1.0f)
+    , mSmoothedMs(0.0f)
+    , mCooldown(0)
+    , mHeadroomFrames(0) {
+}
+
+void DynamicResolution::SetLimits(float minScale, float maxScale) {
+    mMaxScale = std::min(std::max(maxScale, 0.1f), 1.0f);
+    mMinScale = std::min(std::max(minScale, 0.1f), mMaxScale);
+    mScale = mMaxScale;
+}
+
+void DynamicResolution::SetBudget(float budgetMs) {
+    mBudgetMs = std::max(budgetMs, 0.1f);
+}
+
+void DynamicResolution::Update(float renderMs) {
+    mSmoothedMs = mSmoothedMs == 0.0f ? renderMs : mSmoothedMs + (renderMs - mSmoothedMs) * Smoothing;
+
+    if (mCooldown > 0) {
+        --mCooldown;
+        return;
+    }
+
+    float scale = mScale;
+    if (mSmoothedMs > mBudgetMs) {
+        // Fill cost goes with the pixel count, which goes with the square of the scale.
+        scale = std::min(mScale * std::sqrt(mBudgetMs / mSmoothedMs), mScale - ScaleQuantum);
+        mHeadroomFrames = 0;
+    } else if (mSmoothedMs < mBudgetMs * GrowThreshold) {
+        if (++mHeadroomFrames >= GrowAfterFrames) {
+            scale = mScale + GrowStep;
+            mHeadroomFrames = 0;
+        }
+    } else {
+        mHeadroomFrames = 0;
+    }
+
+    scale = std::floor(scale / ScaleQuantum + 0.5f) * ScaleQuantum;
+    scale = std::min(std::max(scale, mMinScale), mMaxScale);
+
+    if (scale != mScale) {
+        mScale = scale;
+        mCooldown = CooldownFrames;
+        // Measure the new scale from scratch.
+        mSmoothedMs = 0.0f;
+    }
+}
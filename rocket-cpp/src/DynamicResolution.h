@@ -0,0 +1,32 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+// Picks the render scale for the next frame from the measured render time, shrinking
+// quickly when over budget and growing back slowly once there is clear headroom.
+class DynamicResolution {
+public:
+    DynamicResolution();
+
+    void SetLimits(float minScale, float maxScale);
+    void SetBudget(float budgetMs);
+
+    // Feeds the render time of the frame just drawn.
+    void Update(float renderMs);
+
+    float GetScale() const {
+        return mScale;
+    }
+
+private:
+    float mMinScale;
+    float mMaxScale;
+    float mBudgetMs;
+
+    float mScale;
+    float mSmoothedMs;
+    // Frames to wait after a change before judging its effect.
+    int mCooldown;
+    int mHeadroomFrames;
+};
+
+#endif // DYNAMIC_RESOLUTION_H
@@ -0,0 +1,335 @@
+#include "FlightRecorder.h"
+
+#include "SDL.h"
+
+#include <csignal>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Frames recorded after a spike before its dump is written.
+    const std::uint32_t FramesAfterSpike = 30;
+
+    const int CrashSignals[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+
+    FlightRecorder* sCrashRecorder = nullptr;
+
+    // Fixed-size text builder that only uses async-signal-safe operations.
+    class Line {
+    public:
+        Line(char* data, std::size_t capacity)
+            : mData(data)
+            , mCapacity(capacity)
+            , mLength(0) {
+            mData[0] = '\0';
+        }
+
+        void Append(const char* text) {
+            while (*text && mLength + 1 < mCapacity) {
+                mData[mLength++] = *text++;
+            }
+            mData[mLength] = '\0';
+        }
+
+        void AppendUnsigned(std::uint64_t value) {
+            char digits[24];
+            int count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value > 0);
+
+            char text[24];
+            for (int i = 0; i < count; ++i) {
+                text[i] = digits[count - 1 - i];
+            }
+            text[count] = '\0';
+            Append(text);
+        }
+
+        void AppendSigned(std::int64_t value) {
+            if (value < 0) {
+                Append("-");
+                AppendUnsigned(static_cast<std::uint64_t>(-(value + 1)) + 1);
+            } else {
+                AppendUnsigned(static_cast<std::uint64_t>(value));
+            }
+        }
+
+        // Three decimals, which is what the stats log uses for milliseconds.
+        void AppendMs(float value) {
+            if (!(value == value) || value > 1e9f || value < -1e9f) {
+                Append("nan");
+                return;
+            }
+
+            if (value < 0.0f) {
+                Append("-");
+                value = -value;
+            }
+
+            std::uint64_t thousandths = static_cast<std::uint64_t>(value * 1000.0f + 0.5f);
+            AppendUnsigned(thousandths / 1000);
+            Append(".");
+
+            std::uint64_t fraction = thousandths % 1000;
+            if (fraction < 100) {
+                Append("0");
+            }
+            if (fraction < 10) {
+                Append("0");
+            }
+            AppendUnsigned(fraction);
+        }
+
+        const char* GetData() const {
+            return mData;
+        }
+
+        std::size_t GetLength() const {
+            return mLength;
+        }
+
+    private:
+        char* mData;
+        std::size_t mCapacity;
+        std::size_t mLength;
+    };
+
+    int OpenForWrite(const char* path) {
+#if defined(_WIN32)
+        return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    }
+
+    bool WriteAll(int fd, const char* data, std::size_t length) {
+        while (length > 0) {
+#if defined(_WIN32)
+            int written = _write(fd, data, static_cast<unsigned int>(length));
+#else
+            ssize_t written = write(fd, data, length);
+#endif
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            length -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    void CloseFile(int fd) {
+#if defined(_WIN32)
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+}
+
+FlightRecorder::FlightRecorder()
+    : mMask(0)
+    , mWritten(0)
+    , mSpikeMs(0.0f)
+    , mSpikeDumpFrame(0)
+    , mSpikesIgnoredUntil(0)
+    , mCrashHandlerInstalled(false) {
+    mPrefix[0] = '\0';
+}
+
+FlightRecorder::~FlightRecorder() {
+    Stop();
+}
+
+void FlightRecorder::Start(int capacity, const std::string& filePrefix, float spikeMs) {
+    std::uint32_t size = 1;
+    while (size < static_cast<std::uint32_t>(capacity)) {
+        size <<= 1;
+    }
+
+    mRecords.assign(size, FlightRecord());
+    mMask = size - 1;
+    mWritten.store(0, std::memory_order_relaxed);
+
+    std::strncpy(mPrefix, filePrefix.c_str(), sizeof(mPrefix) - 1);
+    mPrefix[sizeof(mPrefix) - 1] = '\0';
+    mSpikeMs = spikeMs;
+    mSpikeDumpFrame = 0;
+    mSpikesIgnoredUntil = 0;
+}
+
+void FlightRecorder::Stop() {
+    RemoveCrashHandler();
+    mRecords.clear();
+}
+
+void FlightRecorder::Record(const Stats::Frame& frame, std::uint64_t frameNumber) {
+    if (mRecords.empty()) {
+        return;
+    }
+
+    std::uint32_t written = mWritten.load(std::memory_order_relaxed);
+    FlightRecord& record = mRecords[written & mMask];
+    record.mFrame = static_cast<std::uint32_t>(frameNumber);
+    record.mFrameMs = frame.mFrameMs;
+    for (int i = 0; i < Stats::ENumPhases; ++i) {
+        record.mPhaseMs[i] = frame.mPhaseMs[i];
+    }
+    record.mPresentMs = frame.mPresentMs;
+    record.mPacingMs = frame.mPacingMs;
+    record.mActors = frame.mActors;
+    record.mPendingActors = frame.mPendingActors;
+    record.mSpritesDrawn = frame.mSpritesDrawn;
+    record.mTextures = frame.mTextures;
+    record.mTextureLoads = frame.mTextureLoads;
+    record.mQualityLevel = frame.mQualityLevel;
+    record.mAllocations = static_cast<std::uint32_t>(frame.mAllocations);
+
+    // Publish only complete records to the crash handler.
+    mWritten.store(written + 1, std::memory_order_release);
+
+    if (mSpikeMs > 0.0f && frame.mFrameMs > mSpikeMs && record.mFrame >= mSpikesIgnoredUntil && mSpikeDumpFrame == 0) {
+        SDL_Log("Frame %u took %.1f ms, flight recorder dump in %u frames", record.mFrame, frame.mFrameMs, FramesAfterSpike);
+        mSpikeDumpFrame = record.mFrame + FramesAfterSpike;
+    }
+
+    if (mSpikeDumpFrame != 0 && record.mFrame >= mSpikeDumpFrame) {
+        Dump("spike");
+        mSpikeDumpFrame = 0;
+        mSpikesIgnoredUntil = record.mFrame + (mMask + 1) / 2;
+    }
+}
+
+bool FlightRecorder::Dump(const char* reason) {
+    if (mRecords.empty()) {
+        return false;
+    }
+
+    std::uint32_t written = mWritten.load(std::memory_order_acquire);
+    std::uint32_t frame = written > 0 ? mRecords[(written - 1) & mMask].mFrame : 0;
+
+    char path[512];
+    MakePath(path, sizeof(path), reason, frame);
+    if (!DumpTo(path)) {
+        SDL_Log("Failed to write flight recorder dump %s", path);
+        return false;
+    }
+
+    SDL_Log("Flight recorder dump written to %s", path);
+    return true;
+}
+
+void FlightRecorder::InstallCrashHandler() {
+    if (mRecords.empty() || (sCrashRecorder && sCrashRecorder != this)) {
+        return;
+    }
+
+    sCrashRecorder = this;
+    for (int signal : CrashSignals) {
+        std::signal(signal, &FlightRecorder::OnCrashSignal);
+    }
+    mCrashHandlerInstalled = true;
+}
+
+void FlightRecorder::RemoveCrashHandler() {
+    if (!mCrashHandlerInstalled) {
+        return;
+    }
+
+    for (int signal : CrashSignals) {
+        std::signal(signal, SIG_DFL);
+    }
+    sCrashRecorder = nullptr;
+    mCrashHandlerInstalled = false;
+}
+
+void FlightRecorder::OnCrashSignal(int signal) {
+    FlightRecorder* recorder = sCrashRecorder;
+    sCrashRecorder = nullptr;
+
+    if (recorder) {
+        std::uint32_t written = recorder->mWritten.load(std::memory_order_acquire);
+        std::uint32_t frame = written > 0 ? recorder->mRecords[(written - 1) & recorder->mMask].mFrame : 0;
+
+        char path[512];
+        recorder->MakePath(path, sizeof(path), "crash", frame);
+        recorder->DumpTo(path);
+    }
+
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+void FlightRecorder::MakePath(char* path, std::size_t size, const char* reason, std::uint32_t frame) const {
+    Line line(path, size);
+    line.Append(mPrefix);
+    line.Append("-");
+    line.Append(reason);
+    line.Append("-");
+    line.AppendUnsigned(frame);
+    line.Append(".csv");
+}
+
+bool FlightRecorder::DumpTo(const char* path) const {
+    int fd = OpenForWrite(path);
+    if (fd < 0) {
+        return false;
+    }
+
+    const char* header = "frame,frame_ms,input_ms,update_ms,output_ms,present_ms,pacing_ms,"
+                         "actors,pending_actors,sprites_drawn,textures,texture_loads,quality_level,allocations\n";
+    bool ok = WriteAll(fd, header, std::strlen(header));
+
+    std::uint32_t written = mWritten.load(std::memory_order_acquire);
+    std::uint32_t capacity = mMask + 1;
+    std::uint32_t count = written < capacity ? written : capacity;
+
+    for (std::uint32_t i = written - count; ok && i != written; ++i) {
+        const FlightRecord& record = mRecords[i & mMask];
+
+        char data[256];
+        Line line(data, sizeof(data));
+        line.AppendUnsigned(record.mFrame);
+        line.Append(",");
+        line.AppendMs(record.mFrameMs);
+        for (int phase = 0; phase < Stats::ENumPhases; ++phase) {
+            line.Append(",");
+            line.AppendMs(record.mPhaseMs[phase]);
+        }
+        line.Append(",");
+        line.AppendMs(record.mPresentMs);
+        line.Append(",");
+        line.AppendMs(record.mPacingMs);
+
+        const std::int32_t counts[] = {
+            record.mActors,
+            record.mPendingActors,
+            record.mSpritesDrawn,
+            record.mTextures,
+            record.mTextureLoads,
+            record.mQualityLevel
+        };
+        for (std::int32_t value : counts) {
+            line.Append(",");
+            line.AppendSigned(value);
+        }
+        line.Append(",");
+        line.AppendUnsigned(record.mAllocations);
+        line.Append("\n");
+
+        ok = WriteAll(fd, line.GetData(), line.GetLength());
+    }
+
+    CloseFile(fd);
+    return ok;
+}
@@ -0,0 +1,74 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "Stats.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compact copy of one frame's telemetry.
+struct FlightRecord {
+    std::uint32_t mFrame;
+    float mFrameMs;
+    float mPhaseMs[Stats::ENumPhases];
+    float mPresentMs;
+    float mPacingMs;
+    std::int32_t mActors;
+    std::int32_t mPendingActors;
+    std::int32_t mSpritesDrawn;
+    std::int32_t mTextures;
+    std::int32_t mTextureLoads;
+    std::int32_t mQualityLevel;
+    std::uint32_t mAllocations;
+};
+
+// Always-on ring of the most recent frames, written to a CSV file on request, a
+// few frames after a spike (so the file shows what followed it too), or from a
+// crash signal. Dumps only use async-signal-safe calls and no allocation, so the
+// crash path and the normal path share one writer.
+class FlightRecorder {
+public:
+    FlightRecorder();
+    ~FlightRecorder();
+
+    // Allocates the ring; capacity is rounded up to a power of two. Files are named
+    // <prefix>-<reason>-<frame>.csv. A spike threshold of zero disables spike dumps.
+    void Start(int capacity, const std::string& filePrefix, float spikeMs);
+    void Stop();
+
+    bool IsStarted() const {
+        return !mRecords.empty();
+    }
+
+    void Record(const Stats::Frame& frame, std::uint64_t frameNumber);
+
+    // Writes the ring now; returns false if the file could not be written.
+    bool Dump(const char* reason);
+
+    // Dumps this recorder if the process receives SIGSEGV, SIGABRT, SIGFPE or SIGILL,
+    // then lets the signal take its default action. One recorder per process.
+    void InstallCrashHandler();
+    void RemoveCrashHandler();
+
+private:
+    static void OnCrashSignal(int signal);
+    bool DumpTo(const char* path) const;
+    void MakePath(char* path, std::size_t size, const char* reason, std::uint32_t frame) const;
+
+    std::vector<FlightRecord> mRecords;
+    std::uint32_t mMask;
+    // Total records written; the newest is at (mWritten - 1) & mMask.
+    std::atomic<std::uint32_t> mWritten;
+
+    char mPrefix[256];
+    float mSpikeMs;
+    // Frame at which a pending spike dump is written; zero when none is pending.
+    std::uint32_t mSpikeDumpFrame;
+    // Spikes before this frame are already covered by, or too close to, the last spike dump.
+    std::uint32_t mSpikesIgnoredUntil;
+    bool mCrashHandlerInstalled;
+};
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,91 @@
+#include "FramePacer.h"
+
+#include <cstring>
+
+namespace {
+    const char* const ModeNames[FramePacer::ENumModes] = {
+        "vsync",
+        "uncapped",
+        "capped",
+        "adaptive"
+    };
+
+    // SDL_Delay can oversleep by a scheduler quantum; spin for the last stretch.
+    const Uint32 SpinMs = 2;
+}
+
+FramePacer::FramePacer()
+    : mMode(EVsync)
+    , mNextFrame(0)
+    , mFrequency(SDL_GetPerformanceFrequency()) {
+    SetCapRate(60.0f);
+    SetDisplayRate(60.0f);
+}
+
+const char* FramePacer::GetModeName(Mode mode) {
+    return ModeNames[mode];
+}
+
+bool FramePacer::ParseMode(const char* name, Mode& mode) {
+    for (int i = 0; i < ENumModes; ++i) {
+        if (std::strcmp(name, ModeNames[i]) == 0) {
+            mode = static_cast<Mode>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FramePacer::SetMode(Mode mode) {
+    mMode = mode;
+    mNextFrame = 0;
+}
+
+void FramePacer::SetCapRate(float hz) {
+    mCapPeriod = static_cast<Uint64>(mFrequency / (hz > 0.0f ? hz : 60.0f));
+}
+
+void FramePacer::SetDisplayRate(float hz) {
+    mDisplayPeriod = static_cast<Uint64>(mFrequency / (hz > 0.0f ? hz : 60.0f));
+}
+
+Uint64 FramePacer::GetPeriod() const {
+    return mMode == ECapped ? mCapPeriod : mDisplayPeriod;
+}
+
+float FramePacer::Wait() {
+    if (mMode == EVsync || mMode == EUncapped) {
+        return 0.0f;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 period = GetPeriod();
+
+    if (mNextFrame == 0) {
+        mNextFrame = start + period;
+    } else if (start > mNextFrame) {
+        if (mMode == EAdaptive) {
+            mNextFrame = start + period;
+            return 0.0f;
+        }
+
+        // Skip the slots we missed and wait for the next one.
+        Uint64 missed = (start - mNextFrame) / period + 1;
+        mNextFrame += missed * period;
+    }
+
+    Uint64 spinTicks = mFrequency * SpinMs / 1000;
+    Uint64 now = start;
+    while (now < mNextFrame) {
+        // Pumping keeps input timestamps accurate while we wait.
+        if (mNextFrame - now > spinTicks) {
+            SDL_Delay(1);
+        }
+        SDL_PumpEvents();
+        now = SDL_GetPerformanceCounter();
+    }
+
+    mNextFrame += period;
+    return static_cast<float>((now - start) * 1000.0 / mFrequency);
+}
@@ -0,0 +1,48 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "SDL.h"
+
+// Decides how long to wait after each present.
+class FramePacer {
+public:
+    enum Mode {
+        // The renderer's vsync blocks in SDL_RenderPresent; nothing to do here.
+        EVsync,
+        // Never waits.
+        EUncapped,
+        // Sleeps to a fixed rate; late frames wait for the next slot, like vsync dropping to half rate.
+        ECapped,
+        // Sleeps to the display rate while frames are on time, presents late frames immediately.
+        EAdaptive,
+        ENumModes
+    };
+
+    FramePacer();
+
+    static const char* GetModeName(Mode mode);
+    static bool ParseMode(const char* name, Mode& mode);
+
+    void SetMode(Mode mode);
+
+    Mode GetMode() const {
+        return mMode;
+    }
+
+    void SetCapRate(float hz);
+    void SetDisplayRate(float hz);
+
+    // Called right after present; returns the milliseconds spent waiting.
+    float Wait();
+
+private:
+    Uint64 GetPeriod() const;
+
+    Mode mMode;
+    Uint64 mCapPeriod;
+    Uint64 mDisplayPeriod;
+    Uint64 mNextFrame;
+    Uint64 mFrequency;
+};
+
+#endif // FRAME_PACER_H
@@ -2,58 +2,228 @@
 #include "SDL_image.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 #include "Actor.h"
 #include "BackgroundSpriteComponent.h"
 #include "Ship.h"
 #include "SpriteComponent.h"
 
-Game::Game()
-    : mWindow(nullptr)
+namespace {
+    // mActorIndices value of an actor that is not in mActors yet.
+    const Uint32 NotListed = 0xFFFFFFFF;
+
+    // Places a key transition inside the wall-clock span [tickStart, tickStart + tickLength].
+    KeyChange MakeKeyChange(const InputEvent& event, Uint64 tickStart, Uint64 tickLength) {
+        Uint64 offset = event.mTimestamp > tickStart ? event.mTimestamp - tickStart : 0;
+
+        KeyChange change;
+        change.mScancode = event.mScancode;
+        change.mDown = event.mDown;
+        change.mTickOffset = static_cast<Uint16>(std::min<Uint64>(offset * KeyChange::TickEnd / tickLength, KeyChange::TickEnd));
+        return change;
+    }
+}
+
+Game::Game(const GameConfig& config)
+    : mConfig(config)
+    , mInputTickStart(0)
+    , mNextActorId(1)
+    , mWindow(nullptr)
     , mRenderer(nullptr)
+    , mRenderTarget(nullptr)
+    , mTickIndex(0)
     , mIsRunning(true)
     , mUpdatingActors(false) {
+    mStateEnds[Actor::EActive] = 0;
+    mStateEnds[Actor::EPaused] = 0;
 }
 
 bool Game::Initialize() {
+    if (!mConfig.mSimulationOnly && !InitializePlatform()) {
+        return false;
+    }
+
+    mActions.Bind(SDL_SCANCODE_A, ActionMap::EMoveLeft);
+    mActions.Bind(SDL_SCANCODE_D, ActionMap::EMoveRight);
+    mActions.Bind(SDL_SCANCODE_W, ActionMap::EMoveUp);
+    mActions.Bind(SDL_SCANCODE_S, ActionMap::EMoveDown);
+
+    mGovernor.SetBudget(mConfig.mWorkBudgetMs);
+
+    mStats.SetOverlayEnabled(mConfig.mStatsOverlay);
+    if (mConfig.mHardwareCounters && !mStats.EnableHardwareCounters()) {
+        SDL_Log("Continuing without hardware counters; the stats log will not include them");
+    }
+
+    // The recorder follows RunLoop; simulation-only worlds are stepped directly.
+    if (mConfig.mFlightRecorder && !mConfig.mSimulationOnly) {
+        mFlightRecorder.Start(mConfig.mFlightRecorderFrames, mConfig.mFlightRecorderPrefix, mConfig.mSpikeMs);
+        mFlightRecorder.InstallCrashHandler();
+    }
+    if (!mConfig.mStatsLogFile.empty()) {
+        mStats.OpenLog(mConfig.mStatsLogFile);
+    }
+
+    if (!mConfig.mReplayInputFile.empty()) {
+        if (!mInputLog.StartReplay(mConfig.mReplayInputFile)) {
+            return false;
+        }
+
+        if (mConfig.mFixedDeltaTime <= 0.0f) {
+            float logDeltaTime = mInputLog.GetFixedDeltaTime();
+            mConfig.mFixedDeltaTime = logDeltaTime > 0.0f ? logDeltaTime : 1.0f / 60.0f;
+        }
+    } else if (!mConfig.mRecordInputFile.empty()) {
+        // Key offsets are fractions of a tick, so a replay only matches ticks of the length recorded.
+        if (mConfig.mFixedDeltaTime <= 0.0f) {
+            mConfig.mFixedDeltaTime = 1.0f / 60.0f;
+        }
+        mInputLog.StartRecording(mConfig.mRecordInputFile, mConfig.mFixedDeltaTime);
+    }
+
+    LoadData();
+
+    mTickTime = SDL_GetPerformanceCounter();
+    mInputTickStart = mTickTime;
+
+    return true;
+}
+
+bool Game::InitializePlatform() {
+    if (mConfig.mHeadless) {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         SDL_Log("Unable to initialize SDL: %s", SDL_GetError());
         return false;
     }
 
-    mWindow = SDL_CreateWindow("Rocket Adventures", 100, 100, mScreenWidth, mScreenHeight, 0);
+    mInputQueue.Start();
+
+    // The game still runs silently without an audio device.
+    if (mAudio.Initialize() && !mConfig.mMusicFile.empty()) {
+        mAudio.PlayMusic(mConfig.mMusicFile, mConfig.mMusicBufferMs);
+    }
+
+    Uint32 windowFlags = mConfig.mHeadless ? SDL_WINDOW_HIDDEN : 0;
+    mWindow = SDL_CreateWindow("Rocket Adventures", 100, 100, mScreenWidth, mScreenHeight, windowFlags);
     if (!mWindow) {
         SDL_Log("Failed to create window: %s", SDL_GetError());
     }
 
-    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+    if (mConfig.mPresentMode == FramePacer::EVsync) {
+        rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+    if (mConfig.mHeadless) {
+        rendererFlags = SDL_RENDERER_SOFTWARE;
+    }
+
+    mRenderer = SDL_CreateRenderer(mWindow, -1, rendererFlags);
     if (!mRenderer) {
         SDL_Log("Failed to create renderer: %s", SDL_GetError());
         return false;
     }
 
+    SDL_DisplayMode displayMode;
+    if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(mWindow), &displayMode) == 0 && displayMode.refresh_rate > 0) {
+        mPacer.SetDisplayRate(static_cast<float>(displayMode.refresh_rate));
+    }
+    mPacer.SetCapRate(mConfig.mFrameCapHz);
+
+    FramePacer::Mode presentMode = mConfig.mPresentMode;
+    SDL_RendererInfo rendererInfo;
+    if (presentMode == FramePacer::EVsync &&
+        (SDL_GetRendererInfo(mRenderer, &rendererInfo) != 0 || !(rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC))) {
+        SDL_Log("Renderer has no vsync, pacing to the display rate instead");
+        presentMode = FramePacer::EAdaptive;
+    }
+    mPacer.SetMode(presentMode);
+
+    if (mConfig.mDynamicResolution) {
+        CreateRenderTarget();
+    }
+
     if (IMG_Init(IMG_INIT_PNG) == 0) {
         SDL_Log("Unable to intialize SDL_Image: %s", SDL_GetError());
         return false;
     }
 
-    LoadData();
-
-    mTicksCount = SDL_GetTicks();
-
     return true;
 }
 
 void Game::RunLoop() {
     while (mIsRunning) {
+        mStats.BeginFrame();
+
+        mStats.BeginPhase(Stats::EInput);
         ProcessInput();
+        mStats.EndPhase(Stats::EInput);
+
         UpdateGame();
+
+        if (mConfig.mLateLatch && mInputLog.GetMode() != InputLog::EReplaying) {
+            mStats.BeginPhase(Stats::EInput);
+            LateLatchInput();
+            mStats.EndPhase(Stats::EInput);
+        }
+
+        mStats.BeginPhase(Stats::EOutput);
         GenerateOutput();
+        mStats.EndPhase(Stats::EOutput);
+
+        Stats::Frame& frame = mStats.GetCurrentFrame();
+        frame.mPacingMs = mPacer.Wait();
+
+        // Replays must simulate exactly as recorded and always run at full quality, so the
+        // level stays put while recording as well: it drives particle budgets and update rates.
+        if (mConfig.mQualityGovernor && mInputLog.GetMode() == InputLog::EIdle) {
+            float workMs = frame.mPhaseMs[Stats::EInput] + frame.mPhaseMs[Stats::EUpdate] +
+                           frame.mPhaseMs[Stats::EOutput] - frame.mPresentMs;
+            mGovernor.AddFrame(workMs, mStats.GetFrameCount());
+        }
+        frame.mQualityLevel = mGovernor.GetLevel();
+        frame.mActors = static_cast<int>(mActors.size());
+        frame.mTextures = static_cast<int>(mTextures.size());
+
+        AudioSystem::CallbackStats audio = mAudio.ConsumeCallbackStats();
+        frame.mAudioCallbackMs = audio.mAverageMs;
+        frame.mAudioCallbackMaxMs = audio.mMaxMs;
+        frame.mAudioVoices = audio.mActiveVoices;
+        frame.mMusicBufferedMs = audio.mMusicBufferedMs;
+        frame.mMusicUnderruns = audio.mMusicUnderruns;
+        mStats.EndFrame();
+        mFlightRecorder.Record(mStats.GetLastFrame(), mStats.GetFrameCount() - 1);
+
+        if (mStats.IsOverlayEnabled() && mStats.IsSummaryRefreshed()) {
+            std::string title = std::string("Rocket Adventures | ") + mStats.GetSummary();
+            SDL_SetWindowTitle(mWindow, title.c_str());
+        }
+
+        if (mConfig.mMaxFrames > 0 && mStats.GetFrameCount() >= mConfig.mMaxFrames) {
+            mIsRunning = false;
+        }
     }
 }
 
 void Game::Shutdown() {
+    mFlightRecorder.Stop();
+    mInputLog.Close();
+    mStats.CloseLog();
+    mAudio.Shutdown();
+    mInputQueue.Stop();
     UnloadData();
+
+    if (mConfig.mSimulationOnly) {
+        return;
+    }
+
+    if (mRenderTarget) {
+        SDL_DestroyTexture(mRenderTarget);
+    }
     IMG_Quit();
     SDL_DestroyRenderer(mRenderer);
     SDL_DestroyWindow(mWindow);
@@ -68,70 +238,313 @@ void Game::ProcessInput() {
             case SDL_QUIT:
                 mIsRunning = false;
                 break;
+            case SDL_KEYDOWN:
+                if (event.key.keysym.scancode == SDL_SCANCODE_ESCAPE) {
+                    mIsRunning = false;
+                } else if (event.key.keysym.scancode == SDL_SCANCODE_F2 && !event.key.repeat) {
+                    CyclePresentMode();
+                } else if (event.key.keysym.scancode == SDL_SCANCODE_F3 && !event.key.repeat) {
+                    mFlightRecorder.Dump("manual");
+                } else if (event.key.keysym.scancode == SDL_SCANCODE_F1 && !event.key.repeat) {
+                    mStats.SetOverlayEnabled(!mStats.IsOverlayEnabled());
+                    if (!mStats.IsOverlayEnabled()) {
+                        SDL_SetWindowTitle(mWindow, "Rocket Adventures");
+                    }
+                }
+                break;
+        }
+    }
+}
+
+void Game::CyclePresentMode() {
+    // SDL 2.0.8 cannot turn vsync on or off after the renderer is created.
+    if (mPacer.GetMode() == FramePacer::EVsync) {
+        SDL_Log("Present mode is vsync; start with --present to use another mode");
+        return;
+    }
+
+    FramePacer::Mode next = mPacer.GetMode() == FramePacer::EAdaptive ? FramePacer::EUncapped
+                                                                      : static_cast<FramePacer::Mode>(mPacer.GetMode() + 1);
+    mPacer.SetMode(next);
+    SDL_Log("Present mode %s", FramePacer::GetModeName(next));
+}
+
+bool Game::ConsumeInput() {
+    Uint64 tickEnd = SDL_GetPerformanceCounter();
+    Uint64 tickLength = tickEnd > mInputTickStart ? tickEnd - mInputTickStart : 1;
+
+    // Correction: the simulation restarts from where the last tick left the ship and
+    // integrates the late-latched input itself.
+    mShip->UndoLateLatch();
+
+    mTickChanges.clear();
+    for (const InputEvent& latched : mLatchedEvents) {
+        mTickChanges.emplace_back(MakeKeyChange(latched, mInputTickStart, tickLength));
+    }
+    mLatchedEvents.clear();
+
+    InputEvent event;
+    while (mInputQueue.Pop(event)) {
+        mTickChanges.emplace_back(MakeKeyChange(event, mInputTickStart, tickLength));
+        mUnpresentedInput.emplace_back(event.mTimestamp);
+    }
+    mInputTickStart = tickEnd;
+
+    if (mInputLog.GetMode() == InputLog::EReplaying) {
+        if (!mInputLog.ReplayTick()) {
+            mIsRunning = false;
+            return false;
         }
+
+        // Replayed input has no arrival time; measure from the tick that consumes it.
+        mTickChanges = mInputLog.GetReplayChanges();
+        mUnpresentedInput.assign(mTickChanges.size(), tickEnd);
+    } else {
+        mInputLog.RecordTick(mTickChanges);
     }
 
-    const Uint8* state = SDL_GetKeyboardState(nullptr);
-    if (state[SDL_SCANCODE_ESCAPE]) {
-        mIsRunning = false;
+    ApplyInput(mTickChanges);
+    return true;
+}
+
+void Game::ApplyInput(const std::vector<KeyChange>& changes) {
+    mActions.BeginTick();
+    for (const KeyChange& change : changes) {
+        mActions.ApplyChange(change);
     }
+    mActions.EndTick();
 
-    mShip->ProcessKeyboard(state);
+    mShip->ProcessActions(mActions);
+}
+
+void Game::LateLatchInput() {
+    SDL_PumpEvents();
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 span = now > mInputTickStart ? now - mInputTickStart : 1;
+
+    InputEvent event;
+    while (mInputQueue.Pop(event)) {
+        mLatchedEvents.emplace_back(event);
+        mUnpresentedInput.emplace_back(event.mTimestamp);
+    }
+
+    // Speculative copy; the real action state only advances in ConsumeInput.
+    ActionMap actions = mActions;
+    actions.BeginTick();
+    for (const InputEvent& latched : mLatchedEvents) {
+        actions.ApplyChange(MakeKeyChange(latched, mInputTickStart, span));
+    }
+    actions.EndTick();
+
+    float elapsed = std::min(static_cast<float>(span) / SDL_GetPerformanceFrequency(), 0.05f);
+    mShip->LateLatch(actions, elapsed);
 }
 
 void Game::UpdateGame() {
-    while (!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16))
-        ;
+    if (mConfig.mFixedDeltaTime > 0.0f) {
+        if (ConsumeInput()) {
+            Step(mConfig.mFixedDeltaTime);
+        }
+        return;
+    }
 
-    float deltaTime = (SDL_GetTicks() - mTicksCount) / 1000.0f;
+    // Frame rate is limited by the present mode after each present, not here.
+    Uint64 now = SDL_GetPerformanceCounter();
+    float deltaTime = static_cast<float>(now - mTickTime) / SDL_GetPerformanceFrequency();
     if (deltaTime > 0.05f) {
         deltaTime = 0.05f;
     }
-    mTicksCount = SDL_GetTicks();
+    mTickTime = now;
+
+    if (ConsumeInput()) {
+        Step(deltaTime);
+    }
+}
+
+void Game::Step(float deltaTime) {
+    mStats.BeginPhase(Stats::EUpdate);
 
+    int divisor = GetQuality().mOffscreenUpdateDivisor;
+    if (mConfig.mUpdateLod) {
+        divisor = std::max(divisor, mConfig.mUpdateLodDivisor);
+    }
+    bool sleeping = mConfig.mUpdateLod && mConfig.mUpdateLodSleepRadius > 0.0f && mShip;
+    bool tiered = divisor > 1 || sleeping;
+    if (tiered) {
+        ClassifyUpdates(sleeping);
+    }
+
+    int actorUpdates = 0;
     mUpdatingActors = true;
-    for (auto actor : mActors) {
-        actor->Update(deltaTime);
+    for (size_t i = 0; i < mStateEnds[Actor::EActive]; ++i) {
+        Actor* actor = mActors[i];
+
+        // Partitions only catch up after the loop, so check actors paused or killed earlier this tick.
+        if (!mStateChanges.empty() && actor->GetState() != Actor::EActive) {
+            continue;
+        }
+
+        if (tiered) {
+            Uint8 tier = mUpdateTiers[actor->GetHandle()];
+            // Sleeping actors keep any time skipped before they fell asleep, but gather no more.
+            if (tier == ESleeping) {
+                continue;
+            }
+
+            // Stagger by id, which unlike the index survives partition swaps, so each tick
+            // updates an even share of the reduced-rate actors instead of all of them at once.
+            if (tier == EReducedRate && (mTickIndex + actor->GetId()) % divisor != 0) {
+                actor->SkipUpdate(deltaTime);
+                continue;
+            }
+        }
+
+        actor->Update(deltaTime + actor->TakeSkippedTime());
+        ++actorUpdates;
     }
     mUpdatingActors = false;
+    mStats.GetCurrentFrame().mActorUpdates = actorUpdates;
+    ++mTickIndex;
+
+    for (auto actor : mStateChanges) {
+        MoveActor(mActorIndices[actor->GetHandle()], actor->GetState());
+    }
+    mStateChanges.clear();
+
+    mStats.GetCurrentFrame().mPendingActors = static_cast<int>(mPendingActors.size());
 
     for (auto pending : mPendingActors) {
-        mActors.emplace_back(pending);
+        InsertActor(pending);
     }
     mPendingActors.clear();
 
-    std::vector<Actor*> deadActors;
-    for (auto actor : mActors) {
-        if (actor->GetState() == Actor::EDead) {
-            deadActors.emplace_back(actor);
+    // The dead partition holds only the actors that died since the last sweep.
+    while (mActors.size() > mStateEnds[Actor::EPaused]) {
+        delete mActors.back();
+    }
+
+    mStats.EndPhase(Stats::EUpdate);
+}
+
+void Game::ClassifyUpdates(bool sleeping) {
+    const ActorHotData* hot = mActorHotStore.GetData();
+    Uint32 handles = mActorHotStore.GetHandleCount();
+    mUpdateTiers.resize(handles);
+
+    // Without a ship, or with level of detail off, only visibility counts.
+    Vector2 focus = mShip ? mShip->GetPosition() : Vector2::Zero;
+    bool useDistance = mConfig.mUpdateLod && mShip;
+    float nearSq = useDistance ? mConfig.mUpdateLodNearRadius * mConfig.mUpdateLodNearRadius : -1.0f;
+    float sleepSq = mConfig.mUpdateLodSleepRadius * mConfig.mUpdateLodSleepRadius;
+
+    for (Uint32 handle = 0; handle < handles; ++handle) {
+        const Vector2& position = hot[handle].mPosition;
+        float distanceSq = useDistance ? (position - focus).LengthSq() : 0.0f;
+
+        if (distanceSq < nearSq || IsOnScreen(position)) {
+            mUpdateTiers[handle] = EEveryTick;
+        } else if (!sleeping || distanceSq < sleepSq) {
+            mUpdateTiers[handle] = EReducedRate;
+        } else {
+            mUpdateTiers[handle] = ESleeping;
         }
     }
+}
 
-    for (auto actor : deadActors) {
-        delete actor;
+bool Game::IsOnScreen(const Vector2& position) const {
+    // Actors have no bounds; allow for sprites extending past their position.
+    const float margin = 256.0f;
+    return position.x >= -margin && position.x <= mScreenWidth + margin &&
+           position.y >= -margin && position.y <= mScreenHeight + margin;
+}
+
+bool Game::CreateRenderTarget() {
+    if (!SDL_RenderTargetSupported(mRenderer)) {
+        SDL_Log("Renderer has no render targets, dynamic resolution disabled");
+        return false;
     }
+
+    // Filter only the upscale; sprite textures keep whatever sampling the user or environment chose.
+    const char* hint = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
+    bool hadHint = hint != nullptr;
+    std::string previousHint = hadHint ? hint : "";
+
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+    mRenderTarget = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, mScreenWidth, mScreenHeight);
+    // SDL ignores a null value, so an unset hint goes back to SDL's own default.
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, hadHint ? previousHint.c_str() : "nearest");
+
+    if (!mRenderTarget) {
+        SDL_Log("Failed to create render target: %s", SDL_GetError());
+        return false;
+    }
+
+    mResolution.SetLimits(mConfig.mResolutionMinScale, mConfig.mResolutionMaxScale);
+    mResolution.SetBudget(mConfig.mRenderBudgetMs);
+    return true;
 }
 
 void Game::GenerateOutput() {
+    Uint64 renderStart = SDL_GetPerformanceCounter();
+    float scale = mRenderTarget ? mResolution.GetScale() : 1.0f;
+    mStats.SetRenderScale(scale);
+
     SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
-    SDL_RenderClear(mRenderer);
+    if (mRenderTarget) {
+        // Sprites keep drawing in window coordinates; the scale maps them into the target's top-left corner.
+        SDL_SetRenderTarget(mRenderer, mRenderTarget);
+        SDL_RenderSetScale(mRenderer, scale, scale);
+        SDL_Rect screen = { 0, 0, mScreenWidth, mScreenHeight };
+        SDL_RenderFillRect(mRenderer, &screen);
+    } else {
+        SDL_RenderClear(mRenderer);
+    }
 
     for (auto sprite : mSprites) {
         sprite->Draw(mRenderer);
     }
+    mStats.GetCurrentFrame().mSpritesDrawn = static_cast<int>(mSprites.size());
+
+    if (mRenderTarget) {
+        SDL_SetRenderTarget(mRenderer, nullptr);
+        SDL_Rect source = {
+            0,
+            0,
+            static_cast<int>(mScreenWidth * scale + 0.5f),
+            static_cast<int>(mScreenHeight * scale + 0.5f)
+        };
+        SDL_RenderCopy(mRenderer, mRenderTarget, &source, nullptr);
+
+        float renderMs = static_cast<float>((SDL_GetPerformanceCounter() - renderStart) * 1000.0 / SDL_GetPerformanceFrequency());
+        mResolution.Update(renderMs);
+    }
+
+    if (mStats.IsOverlayEnabled()) {
+        mStats.DrawOverlay(mRenderer);
+    }
 
+    Uint64 presentStart = SDL_GetPerformanceCounter();
     SDL_RenderPresent(mRenderer);
+
+    // With vsync the present blocks until the flip, so this approximates when the frame reaches the screen.
+    Uint64 presented = SDL_GetPerformanceCounter();
+    mStats.GetCurrentFrame().mPresentMs = static_cast<float>((presented - presentStart) * 1000.0 / SDL_GetPerformanceFrequency());
+    for (Uint64 inputTimestamp : mUnpresentedInput) {
+        mStats.AddInputLatency(inputTimestamp, presented);
+    }
+    mUnpresentedInput.clear();
 }
 
 void Game::LoadData() {
-    mShip = new Ship(this);
+    mShip = CreateActor<Ship>();
     mShip->SetPosition(Vector2(150.0f, mScreenHeight / 2.0f));
     mShip->SetScale(0.5f);
 
-    Actor* temp = new Actor(this);
+    Actor* temp = CreateActor<Actor>();
     temp->SetPosition(Vector2(mScreenWidth / 2.0f, mScreenHeight / 2.0f));
 
-    BackgroundSpriteComponent* bg = new BackgroundSpriteComponent(temp);
+    BackgroundSpriteComponent* bg = temp->CreateComponent<BackgroundSpriteComponent>();
     bg->SetScreenSize(Vector2(static_cast<float>(mScreenWidth), static_cast<float>(mScreenHeight)));
     std::vector<SDL_Texture*> texs = {
         GetTexture("assets/background1.png"),
@@ -141,7 +554,7 @@ void Game::LoadData() {
     bg->SetBackgroundTextures(texs);
     bg->SetScrollSpeed(-100.0f);
 
-    bg = new BackgroundSpriteComponent(temp, 50);
+    bg = temp->CreateComponent<BackgroundSpriteComponent>(50);
     bg->SetScreenSize(Vector2(static_cast<float>(mScreenWidth), static_cast<float>(mScreenHeight)));
     texs = {
         GetTexture("assets/stars1.png"),
@@ -149,6 +562,8 @@ void Game::LoadData() {
     };
     bg->SetBackgroundTextures(texs);
     bg->SetScrollSpeed(-200.0f);
+    // The star layer is the first to go when the quality governor needs time back.
+    bg->SetLayerRank(1);
 }
 
 void Game::UnloadData() {
@@ -156,6 +571,12 @@ void Game::UnloadData() {
         delete mActors.back();
     }
 
+    for (auto clip : mAnimationClips) {
+        delete clip.second;
+    }
+
+    mAnimationClips.clear();
+
     for (auto t : mTextures) {
         SDL_DestroyTexture(t.second);
     }
@@ -169,7 +590,7 @@ SDL_Texture* Game::GetTexture(const std::string& fileName) {
     auto iter = mTextures.find(fileName);
     if (iter != mTextures.end()) {
         texture = iter->second;
-    } else {
+    } else if (!mConfig.mSimulationOnly) {
         SDL_Surface* surface = IMG_Load(fileName.c_str());
         if (!surface) {
             SDL_Log("Failed to load texture file %s", fileName.c_str());
@@ -184,30 +605,330 @@ SDL_Texture* Game::GetTexture(const std::string& fileName) {
         }
 
         mTextures.emplace(fileName.c_str(), texture);
+        ++mStats.GetCurrentFrame().mTextureLoads;
     }
 
     return texture;
 }
 
+const AnimationClip* Game::GetAnimationClip(const std::string& name,
+                                            const std::vector<std::string>& textureFiles,
+                                            float fps,
+                                            AnimationClip::LoopMode loopMode) {
+    auto iter = mAnimationClips.find(name);
+    if (iter != mAnimationClips.end()) {
+        return iter->second;
+    }
+
+    if (mConfig.mSimulationOnly) {
+        return AddPlaceholderClip(name, static_cast<int>(textureFiles.size()), fps, loopMode);
+    }
+
+    std::vector<SDL_Texture*> textures;
+    for (const auto& fileName : textureFiles) {
+        SDL_Texture* texture = GetTexture(fileName);
+        if (!texture) {
+            SDL_Log("Animation clip %s is missing frame %s", name.c_str(), fileName.c_str());
+            return nullptr;
+        }
+        textures.emplace_back(texture);
+    }
+
+    AnimationClip* clip = new AnimationClip(textures, fps, loopMode);
+    mAnimationClips.emplace(name, clip);
+
+    return clip;
+}
+
+const AnimationClip* Game::GetPackedAnimationClip(const std::string& name,
+                                                  const std::vector<std::string>& frameFiles,
+                                                  float fps,
+                                                  AnimationClip::LoopMode loopMode) {
+    auto iter = mAnimationClips.find(name);
+    if (iter != mAnimationClips.end()) {
+        return iter->second;
+    }
+
+    if (mConfig.mSimulationOnly) {
+        return AddPlaceholderClip(name, static_cast<int>(frameFiles.size()), fps, loopMode);
+    }
+
+    // Frames are placed left to right with a one pixel gap so filtering never
+    // samples a neighbouring frame.
+    const int padding = 1;
+
+    std::vector<SDL_Surface*> surfaces;
+    std::vector<SDL_Rect> frames;
+    int sheetWidth = 0;
+    int sheetHeight = 0;
+
+    for (const auto& fileName : frameFiles) {
+        SDL_Surface* surface = IMG_Load(fileName.c_str());
+        if (!surface) {
+            // A clip with fewer frames would animate with different timing than its placeholder.
+            SDL_Log("Animation clip %s is missing frame %s", name.c_str(), fileName.c_str());
+            for (auto loaded : surfaces) {
+                SDL_FreeSurface(loaded);
+            }
+            return nullptr;
+        }
+
+        SDL_Rect r;
+        r.x = sheetWidth;
+        r.y = 0;
+        r.w = surface->w;
+        r.h = surface->h;
+        frames.emplace_back(r);
+        surfaces.emplace_back(surface);
+
+        sheetWidth += surface->w + padding;
+        sheetHeight = std::max(sheetHeight, surface->h);
+    }
+
+    SDL_Texture* texture = nullptr;
+    SDL_Surface* sheet = nullptr;
+    if (!surfaces.empty()) {
+        sheet = SDL_CreateRGBSurfaceWithFormat(0, sheetWidth, sheetHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    }
+
+    if (sheet) {
+        SDL_FillRect(sheet, nullptr, 0);
+        for (std::size_t i = 0; i < surfaces.size(); ++i) {
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], nullptr, sheet, &frames[i]);
+        }
+
+        texture = SDL_CreateTextureFromSurface(mRenderer, sheet);
+        SDL_FreeSurface(sheet);
+    }
+
+    for (auto surface : surfaces) {
+        SDL_FreeSurface(surface);
+    }
+
+    if (!texture) {
+        SDL_Log("Failed to build sprite sheet for %s", name.c_str());
+        return nullptr;
+    }
+
+    mTextures.emplace("sheet:" + name, texture);
+    ++mStats.GetCurrentFrame().mTextureLoads;
+
+    AnimationClip* clip = new AnimationClip(texture, frames, fps, loopMode);
+    mAnimationClips.emplace(name, clip);
+
+    return clip;
+}
+
+AnimationClip* Game::AddPlaceholderClip(const std::string& name, int frameCount, float fps, AnimationClip::LoopMode loopMode) {
+    // Keeps the frame count and timing so animation state advances exactly as with textures.
+    SDL_Rect empty = { 0, 0, 0, 0 };
+    AnimationClip* clip = new AnimationClip(nullptr, std::vector<SDL_Rect>(frameCount, empty), fps, loopMode);
+    mAnimationClips.emplace(name, clip);
+
+    return clip;
+}
+
+void Game::SaveSnapshot(WorldSnapshot& snapshot) const {
+    SnapshotWriter writer(snapshot.mData);
+
+    writer.Write(static_cast<Uint32>(mActors.size()));
+    for (auto actor : mActors) {
+        writer.Write(actor->GetId());
+        writer.Write(static_cast<Uint32>(actor->GetComponentCount()));
+    }
+
+    // Input state carries held keys into the next tick; the tick index drives staggering.
+    writer.Write(mActions);
+    writer.Write(mTickIndex);
+
+    for (auto actor : mActors) {
+        actor->SaveState(writer);
+    }
+    writer.Finish();
+}
+
+bool Game::RestoreSnapshot(const WorldSnapshot& snapshot) {
+    if (snapshot.IsEmpty() || mUpdatingActors) {
+        return false;
+    }
+
+    SnapshotReader reader(snapshot.mData);
+    Uint32 count = 0;
+    reader.Read(count);
+
+    // Each actor's block is laid out by its components, so they must still match.
+    bool sameActors = mActors.size() == count;
+    for (Uint32 i = 0; i < count && !reader.HasFailed(); ++i) {
+        Uint32 id = 0;
+        Uint32 componentCount = 0;
+        reader.Read(id);
+        reader.Read(componentCount);
+        sameActors = sameActors && mActors[i]->GetId() == id
+            && static_cast<Uint32>(mActors[i]->GetComponentCount()) == componentCount;
+    }
+    if (reader.HasFailed()) {
+        SDL_Log("Cannot restore snapshot: actor table is truncated");
+        return false;
+    }
+
+    // Rollouts usually leave the actor list untouched; otherwise match actors by id.
+    if (!sameActors) {
+        std::unordered_map<Uint32, Actor*> byId;
+        for (auto actor : mActors) {
+            byId.emplace(actor->GetId(), actor);
+        }
+
+        SnapshotReader idReader(snapshot.mData);
+        idReader.Read(count);
+
+        std::vector<Actor*> restored;
+        for (Uint32 i = 0; i < count; ++i) {
+            Uint32 id = 0;
+            Uint32 componentCount = 0;
+            idReader.Read(id);
+            idReader.Read(componentCount);
+            auto iter = byId.find(id);
+            if (iter == byId.end()) {
+                SDL_Log("Cannot restore snapshot: actor %u no longer exists", id);
+                return false;
+            }
+            if (static_cast<Uint32>(iter->second->GetComponentCount()) != componentCount) {
+                SDL_Log("Cannot restore snapshot: actor %u has %d components, snapshot has %u",
+                        id, iter->second->GetComponentCount(), componentCount);
+                return false;
+            }
+            restored.emplace_back(iter->second);
+            byId.erase(iter);
+        }
+
+        for (auto extra : byId) {
+            delete extra.second;
+        }
+        mActors = restored;
+    }
+
+    reader.Read(mActions);
+    reader.Read(mTickIndex);
+
+    for (auto actor : mActors) {
+        actor->LoadState(reader);
+    }
+
+    if (reader.HasFailed() || !reader.IsAtEnd()) {
+        SDL_Log("Cannot restore snapshot: actor state does not match the snapshot's layout");
+        RebuildPartitions();
+        return false;
+    }
+
+    RebuildPartitions();
+    return true;
+}
+
 void Game::AddActor(Actor* actor) {
+    if (mActorIndices.size() <= actor->GetHandle()) {
+        mActorIndices.resize(actor->GetHandle() + 1, NotListed);
+    }
+
     if (mUpdatingActors) {
+        mActorIndices[actor->GetHandle()] = NotListed;
         mPendingActors.emplace_back(actor);
     } else {
-        mActors.emplace_back(actor);
+        InsertActor(actor);
     }
 }
 
 void Game::RemoveActor(Actor* actor) {
-    auto iter = std::find(mPendingActors.begin(), mPendingActors.end(), actor);
-    if (iter != mPendingActors.end()) {
-        std::iter_swap(iter, mPendingActors.end() - 1);
-        mPendingActors.pop_back();
+    Uint32 index = mActorIndices[actor->GetHandle()];
+    if (index == NotListed) {
+        auto iter = std::find(mPendingActors.begin(), mPendingActors.end(), actor);
+        if (iter != mPendingActors.end()) {
+            std::iter_swap(iter, mPendingActors.end() - 1);
+            mPendingActors.pop_back();
+        }
+    } else {
+        // Through the dead partition to the back, so removal is O(1) like a state change.
+        MoveActor(index, Actor::EDead);
+        SwapActors(mActorIndices[actor->GetHandle()], mActors.size() - 1);
+        mActors.pop_back();
     }
 
-    iter = std::find(mActors.begin(), mActors.end(), actor);
-    if (iter != mActors.end()) {
-        std::iter_swap(iter, mActors.end() - 1);
-        mActors.pop_back();
+    if (!mStateChanges.empty()) {
+        mStateChanges.erase(std::remove(mStateChanges.begin(), mStateChanges.end(), actor), mStateChanges.end());
+    }
+}
+
+void Game::ActorStateChanged(Actor* actor) {
+    Uint32 index = mActorIndices[actor->GetHandle()];
+    if (index == NotListed) {
+        // Pending actors are placed by state when they join mActors.
+        return;
+    }
+
+    if (mUpdatingActors) {
+        mStateChanges.emplace_back(actor);
+    } else {
+        MoveActor(index, actor->GetState());
+    }
+}
+
+void Game::InsertActor(Actor* actor) {
+    // The back of mActors is the dead partition; move down from there.
+    mActors.emplace_back(actor);
+    mActorIndices[actor->GetHandle()] = static_cast<Uint32>(mActors.size() - 1);
+    MoveActor(mActors.size() - 1, actor->GetState());
+}
+
+void Game::MoveActor(std::size_t index, int state) {
+    int partition = GetPartition(index);
+
+    while (partition < state) {
+        std::size_t last = mStateEnds[partition] - 1;
+        SwapActors(index, last);
+        --mStateEnds[partition];
+        index = last;
+        ++partition;
+    }
+
+    while (partition > state) {
+        std::size_t first = mStateEnds[partition - 1];
+        SwapActors(index, first);
+        ++mStateEnds[partition - 1];
+        index = first;
+        --partition;
+    }
+}
+
+void Game::SwapActors(std::size_t a, std::size_t b) {
+    std::swap(mActors[a], mActors[b]);
+    mActorIndices[mActors[a]->GetHandle()] = static_cast<Uint32>(a);
+    mActorIndices[mActors[b]->GetHandle()] = static_cast<Uint32>(b);
+}
+
+int Game::GetPartition(std::size_t index) const {
+    if (index < mStateEnds[Actor::EActive]) {
+        return Actor::EActive;
+    }
+    return index < mStateEnds[Actor::EPaused] ? Actor::EPaused : Actor::EDead;
+}
+
+void Game::RebuildPartitions() {
+    auto byState = [](const Actor* a, const Actor* b) {
+        return a->GetState() < b->GetState();
+    };
+    // Snapshots are saved partitioned, so restoring one normally leaves the order as it is.
+    if (!std::is_sorted(mActors.begin(), mActors.end(), byState)) {
+        std::stable_sort(mActors.begin(), mActors.end(), byState);
+    }
+
+    mStateEnds[Actor::EActive] = 0;
+    mStateEnds[Actor::EPaused] = 0;
+    for (std::size_t i = 0; i < mActors.size(); ++i) {
+        Actor* actor = mActors[i];
+        mActorIndices[actor->GetHandle()] = static_cast<Uint32>(i);
+        for (int state = actor->GetState(); state < Actor::EDead; ++state) {
+            mStateEnds[state] = i + 1;
+        }
     }
 }
 
@@ -1,44 +1,188 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "ActionMap.h"
+#include "Actor.h"
+#include "AnimationClip.h"
+#include "AudioSystem.h"
+#include "DynamicResolution.h"
+#include "FlightRecorder.h"
+#include "FramePacer.h"
+#include "GameConfig.h"
+#include "InputLog.h"
+#include "InputQueue.h"
+#include "Math.h"
+#include "QualityGovernor.h"
 #include "SDL.h"
+#include "Stats.h"
+#include "WorldSnapshot.h"
 
 #include <string>
+#include <utility>
 #include <unordered_map>
 #include <vector>
 
 class Game {
 public:
-    Game();
+    Game(const GameConfig& config = GameConfig());
     bool Initialize();
     void RunLoop();
     void Shutdown();
 
+    void Step(float deltaTime);
+    void GenerateOutput();
+
+    // Advances the action state by one tick of key changes and hands it to the ship.
+    // RunLoop does this from the keyboard; simulation-only worlds call it before each Step.
+    void ApplyInput(const std::vector<KeyChange>& changes);
+
+    // Captures every actor's and component's per-frame state. Call between ticks; the
+    // snapshot's buffer is reused, so repeated captures do not allocate once it has grown.
+    void SaveSnapshot(WorldSnapshot& snapshot) const;
+    // Restores a snapshot of this world in place. Actors created since it was taken are
+    // destroyed; if one of its actors has been destroyed since or has gained or lost components,
+    // nothing changes and false is returned. Component state that still does not fit the snapshot
+    // is caught while loading: false is returned then too, with the world partly restored.
+    bool RestoreSnapshot(const WorldSnapshot& snapshot);
+
+    Uint32 CreateActorId() {
+        return mNextActorId++;
+    }
+
+    ActorHotStore& GetActorHotStore() {
+        return mActorHotStore;
+    }
+
+    // Creates an actor owned by this game. Unlike a plain new, types that do not
+    // override UpdateActor are never asked to run it.
+    template <typename T, typename... Args>
+    T* CreateActor(Args&&... args) {
+        T* actor = new T(this, std::forward<Args>(args)...);
+        actor->SetActorUpdates(HasActorUpdate<T>::value);
+        return actor;
+    }
+
     void AddActor(class Actor* actor);
     void RemoveActor(class Actor* actor);
+    // Called by Actor::SetState after the state in the hot store has changed.
+    void ActorStateChanged(class Actor* actor);
 
     void AddSprite(class SpriteComponent* sprite);
     void RemoveSprite(class SpriteComponent* sprite);
 
+    // Always null in simulation-only worlds, which have no renderer to own textures.
     SDL_Texture* GetTexture(const std::string& fileName);
 
+    // Returns the clip registered under name, building it from the texture files on first use.
+    const AnimationClip* GetAnimationClip(const std::string& name,
+                                          const std::vector<std::string>& textureFiles,
+                                          float fps,
+                                          AnimationClip::LoopMode loopMode = AnimationClip::ELoop);
+    // Packs separate frame images into one sprite sheet texture at load time.
+    const AnimationClip* GetPackedAnimationClip(const std::string& name,
+                                                const std::vector<std::string>& frameFiles,
+                                                float fps,
+                                                AnimationClip::LoopMode loopMode = AnimationClip::ELoop);
+
+    int GetActorCount() const {
+        return static_cast<int>(mActors.size());
+    }
+
+    int GetActiveActorCount() const {
+        return static_cast<int>(mStateEnds[Actor::EActive]);
+    }
+
+    Stats& GetStats() {
+        return mStats;
+    }
+
+    AudioSystem& GetAudio() {
+        return mAudio;
+    }
+
+    const QualitySettings& GetQuality() const {
+        return mGovernor.GetSettings();
+    }
+
 private:
+    // SDL, window, renderer, audio and the input thread; skipped for simulation-only worlds.
+    bool InitializePlatform();
+    // Frame timing of a clip whose textures are not loaded.
+    AnimationClip* AddPlaceholderClip(const std::string& name, int frameCount, float fps, AnimationClip::LoopMode loopMode);
     void ProcessInput();
+    void CyclePresentMode();
+    bool CreateRenderTarget();
+    // Turns input queued since the previous tick into actions; false when a replay has ended.
+    bool ConsumeInput();
+    // Shows the ship with input that arrived during the update; the next tick consumes it properly.
+    void LateLatchInput();
     void UpdateGame();
-    void GenerateOutput();
     void LoadData();
     void UnloadData();
+    bool IsOnScreen(const Vector2& position) const;
+    // Fills mUpdateTiers from the hot store by screen visibility and distance from the ship.
+    void ClassifyUpdates(bool sleeping);
+
+    // Appends to mActors and moves the actor into the partition of its state.
+    void InsertActor(class Actor* actor);
+    // Moves the actor at index into the partition of state, one boundary swap per partition crossed.
+    void MoveActor(std::size_t index, int state);
+    void SwapActors(std::size_t a, std::size_t b);
+    int GetPartition(std::size_t index) const;
+    // Re-partitions mActors after a snapshot restore has rewritten states and order.
+    void RebuildPartitions();
+
+    GameConfig mConfig;
+    Stats mStats;
+    FlightRecorder mFlightRecorder;
+    InputLog mInputLog;
+    InputQueue mInputQueue;
+    ActionMap mActions;
+    std::vector<KeyChange> mTickChanges;
+    // Events already popped by LateLatchInput, waiting for the next tick.
+    std::vector<InputEvent> mLatchedEvents;
+    Uint64 mInputTickStart;
+    // Arrival times of input consumed since the last present, for input-to-present latency.
+    std::vector<Uint64> mUnpresentedInput;
+    AudioSystem mAudio;
 
     std::unordered_map<std::string, SDL_Texture*> mTextures;
+    std::unordered_map<std::string, AnimationClip*> mAnimationClips;
 
+    // Partitioned by state: active actors in [0, mStateEnds[EActive]), paused ones up to
+    // mStateEnds[EPaused], then actors that died since the last sweep.
     std::vector<class Actor*> mActors;
+    std::size_t mStateEnds[Actor::EDead];
+    // Per handle, the actor's index in mActors, or NotListed while it is pending.
+    std::vector<Uint32> mActorIndices;
     std::vector<class Actor*> mPendingActors;
+    // Actors whose state changed during the update loop, moved once it finishes.
+    std::vector<class Actor*> mStateChanges;
+    Uint32 mNextActorId;
+    ActorHotStore mActorHotStore;
+    // Update level of detail.
+    enum UpdateTier {
+        EEveryTick,
+        EReducedRate,
+        ESleeping
+    };
+    // Per handle, refreshed from the hot store each tick when any actor may update at a reduced rate.
+    std::vector<Uint8> mUpdateTiers;
 
     std::vector<class SpriteComponent*> mSprites;
 
     SDL_Window* mWindow;
     SDL_Renderer* mRenderer;
-    Uint32 mTicksCount;
+    FramePacer mPacer;
+
+    // Offscreen target for dynamic resolution; null when drawing straight to the window.
+    SDL_Texture* mRenderTarget;
+    DynamicResolution mResolution;
+
+    QualityGovernor mGovernor;
+    Uint32 mTickIndex;
+    // Performance counter at the start of the previous tick.
+    Uint64 mTickTime;
 
     bool mIsRunning;
 
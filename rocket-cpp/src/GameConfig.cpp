@@ -0,0 +1,123 @@
+#include "GameConfig.h"
+
+#include "SDL.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+void PrintUsage(const char* program) {
+    SDL_Log("Usage: %s [options]\n"
+            "  --headless               no visible window, software rendering, fixed 1/60 s ticks, uncapped\n"
+            "  --fixed-dt <seconds>     advance every tick by a fixed time step\n"
+            "  --frames <count>         quit after the given number of frames\n"
+            "  --present <mode>         vsync (default), uncapped, capped or adaptive; F2 cycles the last three\n"
+            "  --fps-cap <hz>           frame rate for the capped mode (default 60)\n"
+            "  --stats-overlay          show the frame time graph (toggle with F1)\n"
+            "  --stats-log <file>       write per-frame telemetry (.csv, or .json/.jsonl for JSON lines)\n"
+            "  --dynamic-res            scale the render resolution to hold the render budget\n"
+            "  --res-scale-min <s>      smallest render scale (default 0.5)\n"
+            "  --res-scale-max <s>      largest render scale (default 1.0)\n"
+            "  --render-budget-ms <ms>  scene drawing budget for --dynamic-res (default 8)\n"
+            "  --no-quality-governor    keep full quality even when frames run over budget\n"
+            "  --work-budget-ms <ms>    per-frame work budget for the quality governor (default 12)\n"
+            "  --no-update-lod          update every actor every tick regardless of distance\n"
+            "  --lod-near <px>          distance from the ship with full-rate updates (default 640)\n"
+            "  --lod-divisor <n>        distant actors update one tick in n (default 4)\n"
+            "  --lod-sleep <px>         distance beyond which actors sleep; 0 never sleeps (default 4096)\n"
+            "  --late-latch             re-sample input just before rendering the ship\n"
+            "  --record-input <file>    record timestamped key changes per tick to a binary log;\n"
+            "                           ticks are fixed (--fixed-dt, default 1/60 s) while recording\n"
+            "  --replay-input <file>    replay a recorded log with a fixed time step, then quit\n"
+            "  --music <file>           stream a looping 16-bit PCM or IMA ADPCM WAV track\n"
+            "  --music-buffer-ms <ms>   music decode-ahead depth (default 250)\n"
+            "  --hw-counters            log per-phase CPU counters via perf_event_open (Linux)\n"
+            "  --no-flight-recorder     do not keep recent frames for F3, spike and crash dumps\n"
+            "  --flight-prefix <path>   flight recorder dump file prefix (default flight)\n"
+            "  --spike-ms <ms>          dump the flight recorder after a frame this long; 0 disables (default 100)",
+            program);
+}
+} // namespace
+
+bool ParseCommandLine(int argc, char* argv[], GameConfig& config) {
+    bool presentModeSet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--headless") == 0) {
+            config.mHeadless = true;
+        } else if (std::strcmp(arg, "--fixed-dt") == 0 && hasValue) {
+            config.mFixedDeltaTime = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+            config.mMaxFrames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--present") == 0 && hasValue) {
+            if (!FramePacer::ParseMode(argv[++i], config.mPresentMode)) {
+                SDL_Log("Unknown present mode %s", argv[i]);
+                PrintUsage(argv[0]);
+                return false;
+            }
+            presentModeSet = true;
+        } else if (std::strcmp(arg, "--fps-cap") == 0 && hasValue) {
+            config.mFrameCapHz = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--stats-overlay") == 0) {
+            config.mStatsOverlay = true;
+        } else if (std::strcmp(arg, "--stats-log") == 0 && hasValue) {
+            config.mStatsLogFile = argv[++i];
+        } else if (std::strcmp(arg, "--dynamic-res") == 0) {
+            config.mDynamicResolution = true;
+        } else if (std::strcmp(arg, "--res-scale-min") == 0 && hasValue) {
+            config.mResolutionMinScale = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--res-scale-max") == 0 && hasValue) {
+            config.mResolutionMaxScale = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--render-budget-ms") == 0 && hasValue) {
+            config.mRenderBudgetMs = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--no-quality-governor") == 0) {
+            config.mQualityGovernor = false;
+        } else if (std::strcmp(arg, "--work-budget-ms") == 0 && hasValue) {
+            config.mWorkBudgetMs = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--late-latch") == 0) {
+            config.mLateLatch = true;
+        } else if (std::strcmp(arg, "--record-input") == 0 && hasValue) {
+            config.mRecordInputFile = argv[++i];
+        } else if (std::strcmp(arg, "--replay-input") == 0 && hasValue) {
+            config.mReplayInputFile = argv[++i];
+        } else if (std::strcmp(arg, "--music") == 0 && hasValue) {
+            config.mMusicFile = argv[++i];
+        } else if (std::strcmp(arg, "--music-buffer-ms") == 0 && hasValue) {
+            config.mMusicBufferMs = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--no-update-lod") == 0) {
+            config.mUpdateLod = false;
+        } else if (std::strcmp(arg, "--lod-near") == 0 && hasValue) {
+            config.mUpdateLodNearRadius = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--lod-divisor") == 0 && hasValue) {
+            config.mUpdateLodDivisor = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--lod-sleep") == 0 && hasValue) {
+            config.mUpdateLodSleepRadius = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--hw-counters") == 0) {
+            config.mHardwareCounters = true;
+        } else if (std::strcmp(arg, "--no-flight-recorder") == 0) {
+            config.mFlightRecorder = false;
+        } else if (std::strcmp(arg, "--flight-prefix") == 0 && hasValue) {
+            config.mFlightRecorderPrefix = argv[++i];
+        } else if (std::strcmp(arg, "--spike-ms") == 0 && hasValue) {
+            config.mSpikeMs = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            SDL_Log("Unknown or incomplete option %s", arg);
+            PrintUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if (config.mHeadless && config.mFixedDeltaTime <= 0.0f) {
+        config.mFixedDeltaTime = 1.0f / 60.0f;
+    }
+
+    if (config.mHeadless && !presentModeSet) {
+        config.mPresentMode = FramePacer::EUncapped;
+    }
+
+    return true;
+}
@@ -0,0 +1,100 @@
+#ifndef GAME_CONFIG_H
+#define GAME_CONFIG_H
+
+#include "FramePacer.h"
+
+#include <string>
+
+struct GameConfig {
+    GameConfig()
+        : mHeadless(false)
+        , mSimulationOnly(false)
+        , mFixedDeltaTime(0.0f)
+        , mMaxFrames(0)
+        , mPresentMode(FramePacer::EVsync)
+        , mFrameCapHz(60.0f)
+        , mStatsOverlay(false)
+        , mLateLatch(false)
+        , mDynamicResolution(false)
+        , mResolutionMinScale(0.5f)
+        , mResolutionMaxScale(1.0f)
+        , mRenderBudgetMs(8.0f)
+        , mQualityGovernor(true)
+        , mWorkBudgetMs(12.0f)
+        , mUpdateLod(true)
+        , mUpdateLodNearRadius(640.0f)
+        , mUpdateLodDivisor(4)
+        , mUpdateLodSleepRadius(4096.0f)
+        , mMusicBufferMs(250)
+        , mHardwareCounters(false)
+        , mFlightRecorder(true)
+        , mFlightRecorderFrames(1024)
+        , mFlightRecorderPrefix("flight")
+        , mSpikeMs(100.0f) {
+    }
+
+    // Hidden window, software renderer and dummy audio; usable without a display.
+    bool mHeadless;
+    // No SDL platform layer at all: no window, renderer, audio or input thread, and nothing
+    // process-wide is touched, so many such worlds can run side by side on worker threads.
+    // Drive them with Game::Step and Game::ApplyInput; RunLoop and GenerateOutput need the platform.
+    bool mSimulationOnly;
+    // When non-zero every tick advances by this many seconds instead of wall time. Recording
+    // or replaying input sets it to 1/60 s if it was left at zero.
+    float mFixedDeltaTime;
+    // Stop after this many frames; zero runs until quit.
+    unsigned int mMaxFrames;
+
+    // Vsync can only be chosen at startup; the other modes can be switched at runtime with F2.
+    FramePacer::Mode mPresentMode;
+    float mFrameCapHz;
+
+    bool mStatsOverlay;
+    std::string mStatsLogFile;
+
+    // Re-reads input right before rendering and shows the ship where that input puts it.
+    bool mLateLatch;
+
+    // Renders into an offscreen target scaled to keep scene drawing within mRenderBudgetMs.
+    bool mDynamicResolution;
+    float mResolutionMinScale;
+    float mResolutionMaxScale;
+    float mRenderBudgetMs;
+
+    std::string mRecordInputFile;
+    // Replays ticks from an input log instead of the keyboard; takes precedence over recording.
+    std::string mReplayInputFile;
+
+    // Lowers optional work when per-frame work time runs over mWorkBudgetMs. Off while recording
+    // or replaying input, so a replay simulates at the same quality as its recording.
+    bool mQualityGovernor;
+    float mWorkBudgetMs;
+
+    // Update level of detail. Actors on screen or within mUpdateLodNearRadius of the ship update
+    // every tick; the rest update one tick in mUpdateLodDivisor (or the quality governor's
+    // off-screen divisor when larger) with the skipped time folded in, and beyond
+    // mUpdateLodSleepRadius they are not updated at all. A sleep radius of zero never sleeps.
+    bool mUpdateLod;
+    float mUpdateLodNearRadius;
+    int mUpdateLodDivisor;
+    float mUpdateLodSleepRadius;
+
+    // Looping WAV track streamed from disk; mMusicBufferMs is how far the decoder runs ahead.
+    std::string mMusicFile;
+    int mMusicBufferMs;
+
+    // Adds per-phase CPU counters (cycles, instructions, cache and branch misses) to the
+    // stats log. Linux only; ignored with a log message where perf events are not permitted.
+    bool mHardwareCounters;
+
+    // Keeps the last mFlightRecorderFrames frames in memory and writes them to
+    // <prefix>-<reason>-<frame>.csv on F3, after a frame longer than mSpikeMs, or on a crash.
+    bool mFlightRecorder;
+    int mFlightRecorderFrames;
+    std::string mFlightRecorderPrefix;
+    float mSpikeMs;
+};
+
+bool ParseCommandLine(int argc, char* argv[], GameConfig& config);
+
+#endif // GAME_CONFIG_H
@@ -0,0 +1,152 @@
+#include "HardwareCounters.h"
+
+#include "SDL.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+    const char* const CounterNames[HardwareCounters::ENumCounters] = {
+        "cycles",
+        "instructions",
+        "cache_misses",
+        "branch_misses"
+    };
+
+#if defined(__linux__)
+    const std::uint64_t CounterConfigs[HardwareCounters::ENumCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    int OpenCounter(std::uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = groupFd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+#endif
+}
+
+HardwareCounters::HardwareCounters()
+    : mLeader(-1)
+    , mCount(0) {
+    for (int i = 0; i < ENumCounters; ++i) {
+        mFds[i] = -1;
+        mIndex[i] = -1;
+    }
+}
+
+HardwareCounters::~HardwareCounters() {
+    Close();
+}
+
+bool HardwareCounters::Open() {
+    Close();
+
+#if defined(__linux__)
+    int firstError = 0;
+    for (int i = 0; i < ENumCounters; ++i) {
+        int fd = OpenCounter(CounterConfigs[i], mLeader);
+        if (fd < 0) {
+            if (firstError == 0) {
+                firstError = errno;
+            }
+            continue;
+        }
+
+        if (mLeader < 0) {
+            mLeader = fd;
+        }
+        mFds[i] = fd;
+        mIndex[i] = mCount++;
+    }
+
+    if (mCount == 0) {
+        SDL_Log("Hardware counters unavailable: %s", std::strerror(firstError));
+        return false;
+    }
+
+    for (int i = 0; i < ENumCounters; ++i) {
+        if (mIndex[i] < 0) {
+            SDL_Log("Hardware counter %s unavailable", CounterNames[i]);
+        }
+    }
+
+    ioctl(mLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(mLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    SDL_Log("Hardware counters are only supported on Linux");
+    return false;
+#endif
+}
+
+void HardwareCounters::Close() {
+#if defined(__linux__)
+    for (int i = 0; i < ENumCounters; ++i) {
+        if (mFds[i] >= 0) {
+            close(mFds[i]);
+        }
+    }
+#endif
+
+    for (int i = 0; i < ENumCounters; ++i) {
+        mFds[i] = -1;
+        mIndex[i] = -1;
+    }
+    mLeader = -1;
+    mCount = 0;
+}
+
+void HardwareCounters::Read(std::uint64_t values[ENumCounters]) const {
+    for (int i = 0; i < ENumCounters; ++i) {
+        values[i] = 0;
+    }
+
+#if defined(__linux__)
+    if (mCount == 0) {
+        return;
+    }
+
+    // Group read layout: count, time enabled, time running, then one value per member.
+    std::uint64_t data[3 + ENumCounters];
+    if (read(mLeader, data, sizeof(data)) < static_cast<ssize_t>((3 + mCount) * sizeof(std::uint64_t))) {
+        return;
+    }
+
+    std::uint64_t enabled = data[1];
+    std::uint64_t running = data[2];
+    for (int i = 0; i < ENumCounters; ++i) {
+        if (mIndex[i] < 0) {
+            continue;
+        }
+
+        std::uint64_t value = data[3 + mIndex[i]];
+        if (running > 0 && running < enabled) {
+            value = static_cast<std::uint64_t>(static_cast<double>(value) * enabled / running);
+        }
+        values[i] = value;
+    }
+#endif
+}
+
+const char* HardwareCounters::GetName(Counter counter) {
+    return CounterNames[counter];
+}
@@ -0,0 +1,55 @@
+#ifndef HARDWARE_COUNTERS_H
+#define HARDWARE_COUNTERS_H
+
+#include <cstdint>
+
+// CPU performance counters for the calling thread, read through perf_event_open on
+// Linux. Elsewhere, and where the kernel refuses access (containers, a strict
+// perf_event_paranoid, virtual machines without a PMU), Open fails and the
+// engine carries on with wall-clock timings only.
+class HardwareCounters {
+public:
+    enum Counter {
+        ECycles,
+        EInstructions,
+        ECacheMisses,
+        EBranchMisses,
+        ENumCounters
+    };
+
+    HardwareCounters();
+    ~HardwareCounters();
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    // Counts only the thread that calls it. Counters the CPU lacks are left out;
+    // false, with the reason logged, when none could be opened.
+    bool Open();
+    void Close();
+
+    bool IsOpen() const {
+        return mCount > 0;
+    }
+
+    bool IsAvailable(Counter counter) const {
+        return mIndex[counter] >= 0;
+    }
+
+    // Running totals since Open, scaled up if the kernel had to multiplex the counters.
+    // Unavailable counters read as zero.
+    void Read(std::uint64_t values[ENumCounters]) const;
+
+    // Snake-case name used in telemetry fields, e.g. "cache_misses".
+    static const char* GetName(Counter counter);
+
+private:
+    // Group leader descriptor; the other counters are read through it in one call.
+    int mLeader;
+    int mFds[ENumCounters];
+    // Position of each counter in a group read, or -1 when it is not available.
+    int mIndex[ENumCounters];
+    int mCount;
+};
+
+#endif // HARDWARE_COUNTERS_H
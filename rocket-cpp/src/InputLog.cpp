@@ -0,0 +1,191 @@
+#include "InputLog.h"
+
+#include <cstring>
+
+// File layout, little endian:
+//   Uint32 magic, Uint16 version, Uint16 reserved, float fixed delta time,
+//   Uint32 tick count, then for every tick with key changes:
+//   Uint32 tick, Uint16 change count, and per change
+//   Uint16 scancode (high bit set for a press), Uint16 offset within the tick.
+
+InputLog::InputLog()
+    : mFile(nullptr)
+    , mMode(EIdle)
+    , mVersion(Version)
+    , mFixedDeltaTime(0.0f)
+    , mTick(0)
+    , mTickCount(0)
+    , mNextRecordTick(0) {
+    std::memset(mState, 0, sizeof(mState));
+}
+
+InputLog::~InputLog() {
+    Close();
+}
+
+bool InputLog::StartRecording(const std::string& fileName, float fixedDeltaTime) {
+    Close();
+
+    mFile = SDL_RWFromFile(fileName.c_str(), "wb");
+    if (!mFile) {
+        SDL_Log("Failed to open input log %s: %s", fileName.c_str(), SDL_GetError());
+        return false;
+    }
+
+    Uint32 deltaBits;
+    std::memcpy(&deltaBits, &fixedDeltaTime, sizeof(deltaBits));
+
+    SDL_WriteLE32(mFile, Magic);
+    SDL_WriteLE16(mFile, Version);
+    SDL_WriteLE16(mFile, 0);
+    SDL_WriteLE32(mFile, deltaBits);
+    SDL_WriteLE32(mFile, 0);
+
+    mMode = ERecording;
+    mVersion = Version;
+    mFixedDeltaTime = fixedDeltaTime;
+    mTick = 0;
+    mTickCount = 0;
+    std::memset(mState, 0, sizeof(mState));
+
+    return true;
+}
+
+bool InputLog::StartReplay(const std::string& fileName) {
+    Close();
+
+    mFile = SDL_RWFromFile(fileName.c_str(), "rb");
+    if (!mFile) {
+        SDL_Log("Failed to open input log %s: %s", fileName.c_str(), SDL_GetError());
+        return false;
+    }
+
+    Uint32 magic = SDL_ReadLE32(mFile);
+    Uint16 version = SDL_ReadLE16(mFile);
+    SDL_ReadLE16(mFile);
+    Uint32 deltaBits = SDL_ReadLE32(mFile);
+    mTickCount = SDL_ReadLE32(mFile);
+
+    if (magic != Magic || (version != Version && version != StateVersion)) {
+        SDL_Log("%s is not a version %d input log", fileName.c_str(), Version);
+        Close();
+        return false;
+    }
+
+    std::memcpy(&mFixedDeltaTime, &deltaBits, sizeof(mFixedDeltaTime));
+
+    mMode = EReplaying;
+    mVersion = version;
+    mTick = 0;
+    std::memset(mState, 0, sizeof(mState));
+
+    if (!ReadRecordHeader()) {
+        mNextRecordTick = mTickCount;
+    }
+
+    return true;
+}
+
+void InputLog::Close() {
+    if (!mFile) {
+        return;
+    }
+
+    if (mMode == ERecording) {
+        SDL_RWseek(mFile, TickCountOffset, RW_SEEK_SET);
+        SDL_WriteLE32(mFile, mTickCount);
+    }
+
+    SDL_RWclose(mFile);
+    mFile = nullptr;
+    mMode = EIdle;
+}
+
+void InputLog::RecordTick(const std::vector<KeyChange>& changes) {
+    if (mMode != ERecording) {
+        return;
+    }
+
+    if (!changes.empty()) {
+        SDL_WriteLE32(mFile, mTick);
+        SDL_WriteLE16(mFile, static_cast<Uint16>(changes.size()));
+        for (const KeyChange& change : changes) {
+            SDL_WriteLE16(mFile, static_cast<Uint16>(change.mScancode | (change.mDown ? DownFlag : 0)));
+            SDL_WriteLE16(mFile, change.mTickOffset);
+        }
+    }
+
+    ++mTick;
+    mTickCount = mTick;
+}
+
+bool InputLog::ReplayTick() {
+    if (mMode != EReplaying || mTick >= mTickCount) {
+        return false;
+    }
+
+    mChanges.clear();
+
+    if (mTick == mNextRecordTick) {
+        if (mVersion == StateVersion) {
+            ReadStateRecord();
+        } else {
+            ReadChangeRecord();
+        }
+
+        if (!ReadRecordHeader()) {
+            mNextRecordTick = mTickCount;
+        }
+    }
+
+    ++mTick;
+    return true;
+}
+
+void InputLog::ReadStateRecord() {
+    Uint8 state[SDL_NUM_SCANCODES];
+    std::memset(state, 0, sizeof(state));
+
+    Uint16 count = SDL_ReadLE16(mFile);
+    for (Uint16 i = 0; i < count; ++i) {
+        Uint16 scancode = SDL_ReadLE16(mFile);
+        if (scancode < SDL_NUM_SCANCODES) {
+            state[scancode] = 1;
+        }
+    }
+
+    for (int i = 0; i < SDL_NUM_SCANCODES; ++i) {
+        if (state[i] != mState[i]) {
+            KeyChange change;
+            change.mScancode = static_cast<Uint16>(i);
+            change.mDown = state[i] != 0;
+            change.mTickOffset = 0;
+            mChanges.emplace_back(change);
+        }
+    }
+
+    std::memcpy(mState, state, sizeof(mState));
+}
+
+void InputLog::ReadChangeRecord() {
+    Uint16 count = SDL_ReadLE16(mFile);
+    for (Uint16 i = 0; i < count; ++i) {
+        Uint16 code = SDL_ReadLE16(mFile);
+
+        KeyChange change;
+        change.mScancode = static_cast<Uint16>(code & ~DownFlag);
+        change.mDown = (code & DownFlag) != 0;
+        change.mTickOffset = SDL_ReadLE16(mFile);
+        mChanges.emplace_back(change);
+    }
+}
+
+bool InputLog::ReadRecordHeader() {
+    Uint32 tick;
+    if (SDL_RWread(mFile, &tick, sizeof(tick), 1) != 1) {
+        return false;
+    }
+
+    mNextRecordTick = SDL_SwapLE32(tick);
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include "ActionMap.h"
+#include "SDL.h"
+
+#include <string>
+#include <vector>
+
+// Per-tick key change log. Only ticks with key transitions are stored, with each
+// transition's offset inside the tick so replays reproduce sub-tick timing exactly.
+class InputLog {
+public:
+    enum Mode {
+        EIdle,
+        ERecording,
+        EReplaying
+    };
+
+    InputLog();
+    ~InputLog();
+
+    bool StartRecording(const std::string& fileName, float fixedDeltaTime);
+    bool StartReplay(const std::string& fileName);
+    void Close();
+
+    // Appends the key changes of the next tick.
+    void RecordTick(const std::vector<KeyChange>& changes);
+    // Advances to the next tick; returns false when the log is exhausted.
+    bool ReplayTick();
+
+    // Key changes of the tick entered by the last ReplayTick.
+    const std::vector<KeyChange>& GetReplayChanges() const {
+        return mChanges;
+    }
+
+    Mode GetMode() const {
+        return mMode;
+    }
+
+    float GetFixedDeltaTime() const {
+        return mFixedDeltaTime;
+    }
+
+    Uint32 GetTickCount() const {
+        return mTickCount;
+    }
+
+private:
+    bool ReadRecordHeader();
+    void ReadStateRecord();
+    void ReadChangeRecord();
+
+    static const Uint32 Magic = 0x4e494b52; // "RKIN"
+    static const Uint16 Version = 2;
+    // Version 1 logs stored the full pressed set per changed tick; they replay as changes at tick start.
+    static const Uint16 StateVersion = 1;
+    static const Uint16 DownFlag = 0x8000;
+    static const Sint64 TickCountOffset = 12;
+
+    SDL_RWops* mFile;
+    Mode mMode;
+    Uint16 mVersion;
+    float mFixedDeltaTime;
+    Uint32 mTick;
+    Uint32 mTickCount;
+    Uint32 mNextRecordTick;
+    Uint8 mState[SDL_NUM_SCANCODES];
+    std::vector<KeyChange> mChanges;
+};
+
+#endif // INPUT_LOG_H
@@ -0,0 +1,43 @@
+#include "InputQueue.h"
+
+InputQueue::InputQueue()
+    : mDropped(0)
+    , mStarted(false) {
+}
+
+InputQueue::~InputQueue() {
+    Stop();
+}
+
+void InputQueue::Start() {
+    if (!mStarted) {
+        SDL_AddEventWatch(EventWatch, this);
+        mStarted = true;
+    }
+}
+
+void InputQueue::Stop() {
+    if (mStarted) {
+        SDL_DelEventWatch(EventWatch, this);
+        mStarted = false;
+    }
+}
+
+int SDLCALL InputQueue::EventWatch(void* userdata, SDL_Event* event) {
+    if ((event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) || event->key.repeat) {
+        return 0;
+    }
+
+    InputQueue* queue = static_cast<InputQueue*>(userdata);
+
+    InputEvent input;
+    input.mTimestamp = SDL_GetPerformanceCounter();
+    input.mScancode = static_cast<Uint16>(event->key.keysym.scancode);
+    input.mDown = event->type == SDL_KEYDOWN;
+
+    if (!queue->mEvents.Push(input)) {
+        queue->mDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include "SDL.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+
+struct InputEvent {
+    // SDL_GetPerformanceCounter() when SDL delivered the event.
+    Uint64 mTimestamp;
+    Uint16 mScancode;
+    bool mDown;
+};
+
+// Collects key transitions with high resolution timestamps the moment SDL pumps them,
+// independent of where the frame is, and hands them to the simulation lock-free.
+class InputQueue {
+public:
+    InputQueue();
+    ~InputQueue();
+
+    void Start();
+    void Stop();
+
+    bool Pop(InputEvent& event) {
+        return mEvents.Pop(event);
+    }
+
+    // Events lost because the simulation fell behind by more than the queue holds.
+    Uint32 GetDroppedCount() const {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static int SDLCALL EventWatch(void* userdata, SDL_Event* event);
+
+    SpscQueue<InputEvent, 256> mEvents;
+    std::atomic<Uint32> mDropped;
+    bool mStarted;
+};
+
+#endif // INPUT_QUEUE_H
@@ -1,8 +1,14 @@
 #define SDL_MAIN_HANDLED
 #include "Game.h"
+#include "GameConfig.h"
 
-int main() {
-    Game game;
+int main(int argc, char* argv[]) {
+    GameConfig config;
+    if (!ParseCommandLine(argc, argv, config)) {
+        return 1;
+    }
+
+    Game game(config);
     bool success = game.Initialize();
 
     if (success) {
@@ -0,0 +1,338 @@
+#include "MusicStream.h"
+
+#include <algorithm>
+
+namespace {
+    const Uint32 RiffId = 0x46464952; // "RIFF"
+    const Uint32 WaveId = 0x45564157; // "WAVE"
+    const Uint32 FormatId = 0x20746d66; // "fmt "
+    const Uint32 DataId = 0x61746164; // "data"
+
+    const Uint16 FormatPcm = 1;
+    const Uint16 FormatImaAdpcm = 0x11;
+
+    const int Pcm16BlockFrames = 1024;
+
+    const int ImaIndexTable[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8,
+        -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+    const int ImaStepTable[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+        253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+        1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+        12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    Sint16 ReadSample(const Uint8* bytes) {
+        return static_cast<Sint16>(bytes[0] | (bytes[1] << 8));
+    }
+}
+
+MusicStream::MusicStream(int deviceRate, int bufferMs)
+    : mDeviceRate(deviceRate)
+    , mRing(static_cast<size_t>(std::max(deviceRate * std::max(bufferMs, 10) / 1000, ChunkFrames * 2)) * Channels)
+    , mFile(nullptr)
+    , mThread(nullptr)
+    , mRunning(false)
+    , mFinished(false)
+    , mPrimed(false)
+    , mUnderruns(0)
+    , mLoop(false)
+    , mEncoding(EPcm16)
+    , mSourceChannels(0)
+    , mSourceRate(0)
+    , mBlockAlign(0)
+    , mBlockFrames(0)
+    , mDataStart(0)
+    , mDataSize(0)
+    , mDataRemaining(0)
+    , mSourceFrames(0)
+    , mSourcePosition(0.0)
+    , mStep(1.0) {
+}
+
+MusicStream::~MusicStream() {
+    Close();
+}
+
+bool MusicStream::Open(const std::string& fileName, bool loop) {
+    Close();
+
+    mFile = SDL_RWFromFile(fileName.c_str(), "rb");
+    if (!mFile) {
+        SDL_Log("Failed to open music %s", fileName.c_str());
+        return false;
+    }
+
+    if (SDL_ReadLE32(mFile) != RiffId) {
+        SDL_Log("Music %s is not a RIFF file", fileName.c_str());
+        Close();
+        return false;
+    }
+
+    SDL_ReadLE32(mFile);
+    if (SDL_ReadLE32(mFile) != WaveId) {
+        SDL_Log("Music %s is not a WAVE file", fileName.c_str());
+        Close();
+        return false;
+    }
+
+    Uint16 format = 0;
+    Uint16 bitsPerSample = 0;
+    int samplesPerBlock = 0;
+    mDataStart = 0;
+
+    Uint32 header[2];
+    while (SDL_RWread(mFile, header, sizeof(header), 1) == 1) {
+        Uint32 id = SDL_SwapLE32(header[0]);
+        Uint32 size = SDL_SwapLE32(header[1]);
+        Sint64 chunkStart = SDL_RWtell(mFile);
+
+        if (id == FormatId) {
+            format = SDL_ReadLE16(mFile);
+            mSourceChannels = SDL_ReadLE16(mFile);
+            mSourceRate = static_cast<int>(SDL_ReadLE32(mFile));
+            SDL_ReadLE32(mFile);
+            mBlockAlign = SDL_ReadLE16(mFile);
+            bitsPerSample = SDL_ReadLE16(mFile);
+            if (format == FormatImaAdpcm && size >= 20) {
+                SDL_ReadLE16(mFile);
+                samplesPerBlock = SDL_ReadLE16(mFile);
+            }
+        } else if (id == DataId) {
+            mDataStart = chunkStart;
+            mDataSize = size;
+            break;
+        }
+
+        SDL_RWseek(mFile, chunkStart + size + (size & 1), RW_SEEK_SET);
+    }
+
+    bool supportedChannels = mSourceChannels == 1 || mSourceChannels == 2;
+    if (format == FormatPcm && bitsPerSample == 16 && supportedChannels) {
+        mEncoding = EPcm16;
+        mBlockFrames = Pcm16BlockFrames;
+        mBlock.resize(mBlockFrames * mSourceChannels * sizeof(Sint16));
+    } else if (format == FormatImaAdpcm && bitsPerSample == 4 && supportedChannels &&
+               mBlockAlign > 4 * mSourceChannels) {
+        mEncoding = EImaAdpcm;
+        // One sample in the block header plus eight per four-byte group.
+        int derivedFrames = (mBlockAlign - 4 * mSourceChannels) * 2 / mSourceChannels + 1;
+        mBlockFrames = samplesPerBlock > 0 ? std::min(samplesPerBlock, derivedFrames) : derivedFrames;
+        mBlock.resize(mBlockAlign);
+    } else {
+        SDL_Log("Music %s must be 16-bit PCM or IMA ADPCM, mono or stereo", fileName.c_str());
+        Close();
+        return false;
+    }
+
+    if (mDataStart == 0 || mSourceRate <= 0) {
+        SDL_Log("Music %s has no audio data", fileName.c_str());
+        Close();
+        return false;
+    }
+
+    mSource.assign((mBlockFrames + 1) * Channels, 0.0f);
+    mSourceFrames = 0;
+    mSourcePosition = 0.0;
+    mStep = static_cast<double>(mSourceRate) / mDeviceRate;
+    mLoop = loop;
+    mDataRemaining = mDataSize;
+
+    mFinished = false;
+    mPrimed = false;
+    mRunning = true;
+    mThread = SDL_CreateThread(WorkerMain, "music", this);
+    if (!mThread) {
+        SDL_Log("Failed to start music thread: %s", SDL_GetError());
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MusicStream::Close() {
+    mRunning = false;
+    if (mThread) {
+        SDL_WaitThread(mThread, nullptr);
+        mThread = nullptr;
+    }
+
+    if (mFile) {
+        SDL_RWclose(mFile);
+        mFile = nullptr;
+    }
+}
+
+int MusicStream::Read(float* out, int frames) {
+    int read = static_cast<int>(mRing.Read(out, static_cast<size_t>(frames) * Channels) / Channels);
+
+    // Starting silent while the worker fills the first chunk is not a glitch.
+    if (read < frames && mPrimed.load(std::memory_order_acquire) && !mFinished.load(std::memory_order_acquire)) {
+        mUnderruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return read;
+}
+
+int SDLCALL MusicStream::WorkerMain(void* data) {
+    static_cast<MusicStream*>(data)->Work();
+    return 0;
+}
+
+void MusicStream::Work() {
+    std::vector<float> chunk(ChunkFrames * Channels);
+    // Wake often enough to top the ring up several times per buffer length.
+    Uint32 pollMs = std::max<Uint32>(1, static_cast<Uint32>(mRing.GetCapacity() * 1000 / (Channels * mDeviceRate) / 8));
+
+    while (mRunning.load(std::memory_order_relaxed)) {
+        if (mRing.GetWriteAvailable() < chunk.size()) {
+            SDL_Delay(pollMs);
+            continue;
+        }
+
+        int produced = Produce(chunk.data(), ChunkFrames);
+        mRing.Write(chunk.data(), static_cast<size_t>(produced) * Channels);
+        mPrimed.store(true, std::memory_order_release);
+
+        if (produced < ChunkFrames) {
+            mFinished.store(true, std::memory_order_release);
+            break;
+        }
+    }
+}
+
+int MusicStream::Produce(float* out, int frames) {
+    int produced = 0;
+
+    while (produced < frames) {
+        int index = static_cast<int>(mSourcePosition);
+        if (index + 1 >= mSourceFrames) {
+            if (!Refill()) {
+                break;
+            }
+            continue;
+        }
+
+        // Linear interpolation from the file rate to the device rate.
+        float fraction = static_cast<float>(mSourcePosition - index);
+        const float* a = &mSource[index * Channels];
+        const float* b = a + Channels;
+        out[produced * Channels] = a[0] + (b[0] - a[0]) * fraction;
+        out[produced * Channels + 1] = a[1] + (b[1] - a[1]) * fraction;
+
+        mSourcePosition += mStep;
+        ++produced;
+    }
+
+    return produced;
+}
+
+bool MusicStream::Refill() {
+    // Carry the last frame over so interpolation is continuous across blocks.
+    int consumed = std::min(static_cast<int>(mSourcePosition), mSourceFrames);
+    int keep = mSourceFrames - consumed;
+    std::copy(mSource.begin() + consumed * Channels, mSource.begin() + mSourceFrames * Channels, mSource.begin());
+    mSourcePosition -= consumed;
+
+    int decoded = DecodeBlock(&mSource[keep * Channels]);
+    if (decoded == 0 && mLoop) {
+        Rewind();
+        decoded = DecodeBlock(&mSource[keep * Channels]);
+    }
+
+    mSourceFrames = keep + decoded;
+    return decoded > 0;
+}
+
+int MusicStream::DecodeBlock(float* out) {
+    int frames = mEncoding == EPcm16 ? DecodePcm16(out) : DecodeImaAdpcm(out);
+
+    if (mSourceChannels == 1) {
+        for (int i = 0; i < frames; ++i) {
+            out[i * Channels + 1] = out[i * Channels];
+        }
+    }
+
+    return frames;
+}
+
+int MusicStream::DecodePcm16(float* out) {
+    int frameBytes = mSourceChannels * static_cast<int>(sizeof(Sint16));
+    int frames = std::min(mBlockFrames, static_cast<int>(mDataRemaining / frameBytes));
+    int bytes = frames * frameBytes;
+    if (frames == 0 || SDL_RWread(mFile, mBlock.data(), 1, bytes) != static_cast<size_t>(bytes)) {
+        return 0;
+    }
+    mDataRemaining -= bytes;
+
+    for (int i = 0; i < frames; ++i) {
+        for (int c = 0; c < mSourceChannels; ++c) {
+            out[i * Channels + c] = ReadSample(&mBlock[(i * mSourceChannels + c) * 2]) / 32768.0f;
+        }
+    }
+
+    return frames;
+}
+
+int MusicStream::DecodeImaAdpcm(float* out) {
+    int bytes = std::min(mBlockAlign, static_cast<int>(mDataRemaining));
+    int headerBytes = 4 * mSourceChannels;
+    if (bytes <= headerBytes || SDL_RWread(mFile, mBlock.data(), 1, bytes) != static_cast<size_t>(bytes)) {
+        return 0;
+    }
+    mDataRemaining -= bytes;
+
+    // Each channel contributes four bytes (eight nibbles) per group, interleaved.
+    int groups = (bytes - headerBytes) / headerBytes;
+    int frames = std::min(1 + groups * 8, mBlockFrames);
+
+    for (int c = 0; c < mSourceChannels; ++c) {
+        const Uint8* header = &mBlock[c * 4];
+        int predictor = ReadSample(header);
+        int index = std::min<int>(header[2], 88);
+        out[c] = predictor / 32768.0f;
+
+        for (int g = 0; g < groups; ++g) {
+            const Uint8* data = &mBlock[headerBytes + (g * mSourceChannels + c) * 4];
+            for (int n = 0; n < 8; ++n) {
+                int frame = 1 + g * 8 + n;
+                if (frame >= frames) {
+                    break;
+                }
+
+                int nibble = (data[n / 2] >> ((n & 1) * 4)) & 0x0f;
+                int step = ImaStepTable[index];
+                int diff = step >> 3;
+                if (nibble & 1) {
+                    diff += step >> 2;
+                }
+                if (nibble & 2) {
+                    diff += step >> 1;
+                }
+                if (nibble & 4) {
+                    diff += step;
+                }
+                if (nibble & 8) {
+                    diff = -diff;
+                }
+
+                predictor = std::min(std::max(predictor + diff, -32768), 32767);
+                index = std::min(std::max(index + ImaIndexTable[nibble], 0), 88);
+                out[frame * Channels + c] = predictor / 32768.0f;
+            }
+        }
+    }
+
+    return frames;
+}
+
+void MusicStream::Rewind() {
+    SDL_RWseek(mFile, mDataStart, RW_SEEK_SET);
+    mDataRemaining = mDataSize;
+}
@@ -0,0 +1,85 @@
+#ifndef MUSIC_STREAM_H
+#define MUSIC_STREAM_H
+
+#include "SDL.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Decodes a WAV file (PCM16 or IMA ADPCM) incrementally on a worker thread into a
+// ring of device-rate stereo floats, so memory use does not depend on track length.
+class MusicStream {
+public:
+    MusicStream(int deviceRate, int bufferMs);
+    ~MusicStream();
+
+    // Parses the header and starts the worker; decoding happens in the background.
+    bool Open(const std::string& fileName, bool loop);
+    void Close();
+
+    // Audio callback side. Fills up to frames stereo frames and returns how many were
+    // available; a short read before the end of the track counts as an underrun.
+    int Read(float* out, int frames);
+
+    bool IsFinished() const {
+        return mFinished.load(std::memory_order_acquire) && mRing.GetReadAvailable() == 0;
+    }
+
+    Uint32 GetUnderruns() const {
+        return mUnderruns.load(std::memory_order_relaxed);
+    }
+
+    float GetBufferedMs() const {
+        return 1000.0f * mRing.GetReadAvailable() / (Channels * mDeviceRate);
+    }
+
+private:
+    static const int Channels = 2;
+    static const int ChunkFrames = 512;
+
+    enum Encoding {
+        EPcm16,
+        EImaAdpcm
+    };
+
+    static int SDLCALL WorkerMain(void* data);
+
+    void Work();
+    int Produce(float* out, int frames);
+    bool Refill();
+    int DecodeBlock(float* out);
+    int DecodePcm16(float* out);
+    int DecodeImaAdpcm(float* out);
+    void Rewind();
+
+    int mDeviceRate;
+    SpscRingBuffer<float> mRing;
+
+    SDL_RWops* mFile;
+    SDL_Thread* mThread;
+    std::atomic<bool> mRunning;
+    std::atomic<bool> mFinished;
+    std::atomic<bool> mPrimed;
+    std::atomic<Uint32> mUnderruns;
+    bool mLoop;
+
+    Encoding mEncoding;
+    int mSourceChannels;
+    int mSourceRate;
+    int mBlockAlign;
+    int mBlockFrames;
+    Sint64 mDataStart;
+    Uint32 mDataSize;
+    Uint32 mDataRemaining;
+
+    // Worker-only decode state: stereo source frames and the resampling cursor into them.
+    std::vector<Uint8> mBlock;
+    std::vector<float> mSource;
+    int mSourceFrames;
+    double mSourcePosition;
+    double mStep;
+};
+
+#endif // MUSIC_STREAM_H
@@ -0,0 +1,257 @@
+#include "ParticleSystemComponent.h"
+#include "Actor.h"
+#include "Game.h"
+#include "WorldSnapshot.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE2 1
+#endif
+
+ParticleSystemComponent::ParticleSystemComponent(Actor* owner, int maxParticles, int drawOrder)
+    : SpriteComponent(owner, drawOrder)
+    , mMaxParticles(Math::Max(maxParticles, 0))
+    , mCount(0)
+    , mEmitRate(0.0f)
+    , mEmitAccumulator(0.0f)
+    , mDirection(0.0f)
+    , mSpread(Math::Pi)
+    , mMinSpeed(50.0f)
+    , mMaxSpeed(100.0f)
+    , mMinLifetime(0.5f)
+    , mMaxLifetime(1.0f)
+    , mDrag(0.0f)
+    , mStartColor(Color::White)
+    , mStartAlpha(1.0f)
+    , mEndColor(Color::White)
+    , mEndAlpha(0.0f)
+    , mStartSize(4.0f)
+    , mEndSize(1.0f)
+    , mBudgetScale(1.0f)
+    , mRandomState(0x9e3779b9u) {
+    mPositionX.resize(mMaxParticles);
+    mPositionY.resize(mMaxParticles);
+    mVelocityX.resize(mMaxParticles);
+    mVelocityY.resize(mMaxParticles);
+    mLife.resize(mMaxParticles);
+    mInverseLifetime.resize(mMaxParticles);
+    mAge.resize(mMaxParticles);
+
+    mRects.resize(mMaxParticles);
+}
+
+void ParticleSystemComponent::Update(float deltaTime) {
+    SpriteComponent::Update(deltaTime);
+
+    Simulate(deltaTime);
+    RemoveDead();
+
+    mEmitAccumulator += mEmitRate * deltaTime;
+    int toEmit = static_cast<int>(mEmitAccumulator);
+    mEmitAccumulator -= toEmit;
+    Emit(toEmit);
+}
+
+void ParticleSystemComponent::SaveState(SnapshotWriter& writer) const {
+    SpriteComponent::SaveState(writer);
+    writer.Write(mEmitAccumulator);
+    writer.Write(mRandomState);
+
+    // Only live particles; the rest of each array is scratch.
+    writer.Write(mCount);
+    writer.WriteArray(mPositionX.data(), mCount);
+    writer.WriteArray(mPositionY.data(), mCount);
+    writer.WriteArray(mVelocityX.data(), mCount);
+    writer.WriteArray(mVelocityY.data(), mCount);
+    writer.WriteArray(mLife.data(), mCount);
+    writer.WriteArray(mInverseLifetime.data(), mCount);
+    writer.WriteArray(mAge.data(), mCount);
+}
+
+void ParticleSystemComponent::LoadState(SnapshotReader& reader) {
+    SpriteComponent::LoadState(reader);
+    reader.Read(mEmitAccumulator);
+    reader.Read(mRandomState);
+
+    reader.Read(mCount);
+    if (mCount < 0 || mCount > mMaxParticles) {
+        mCount = 0;
+        reader.Fail();
+    }
+    reader.ReadArray(mPositionX.data(), mCount);
+    reader.ReadArray(mPositionY.data(), mCount);
+    reader.ReadArray(mVelocityX.data(), mCount);
+    reader.ReadArray(mVelocityY.data(), mCount);
+    reader.ReadArray(mLife.data(), mCount);
+    reader.ReadArray(mInverseLifetime.data(), mCount);
+    reader.ReadArray(mAge.data(), mCount);
+}
+
+void ParticleSystemComponent::Burst(int count) {
+    Emit(count);
+}
+
+void ParticleSystemComponent::Emit(int count) {
+    int budget = static_cast<int>(mMaxParticles * mBudgetScale * mOwner->GetGame()->GetQuality().mParticleBudget);
+    count = Math::Min(count, budget - mCount);
+
+    Vector2 origin = mOwner->GetPosition() + mEmitOffset;
+
+    for (int n = 0; n < count; ++n) {
+        int i = mCount++;
+
+        float angle = mDirection + (Random() * 2.0f - 1.0f) * mSpread;
+        float speed = Math::Lerp(mMinSpeed, mMaxSpeed, Random());
+        float lifetime = Math::Max(Math::Lerp(mMinLifetime, mMaxLifetime, Random()), 0.001f);
+
+        mPositionX[i] = origin.x;
+        mPositionY[i] = origin.y;
+        mVelocityX[i] = Math::Cos(angle) * speed;
+        mVelocityY[i] = Math::Sin(angle) * speed;
+        mLife[i] = lifetime;
+        mInverseLifetime[i] = 1.0f / lifetime;
+        mAge[i] = 0.0f;
+    }
+}
+
+void ParticleSystemComponent::Simulate(float deltaTime) {
+    const float damping = Math::Max(1.0f - mDrag * deltaTime, 0.0f);
+    const float gravityX = mGravity.x * deltaTime;
+    const float gravityY = mGravity.y * deltaTime;
+
+    float* px = mPositionX.data();
+    float* py = mPositionY.data();
+    float* vx = mVelocityX.data();
+    float* vy = mVelocityY.data();
+    float* life = mLife.data();
+    const float* inverseLifetime = mInverseLifetime.data();
+    float* age = mAge.data();
+
+    int i = 0;
+
+#ifdef PARTICLES_USE_SSE2
+    const __m128 dt4 = _mm_set1_ps(deltaTime);
+    const __m128 damping4 = _mm_set1_ps(damping);
+    const __m128 gravityX4 = _mm_set1_ps(gravityX);
+    const __m128 gravityY4 = _mm_set1_ps(gravityY);
+    const __m128 one4 = _mm_set1_ps(1.0f);
+    const __m128 zero4 = _mm_setzero_ps();
+
+    for (; i + 4 <= mCount; i += 4) {
+        __m128 velX = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), gravityX4), damping4);
+        __m128 velY = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), gravityY4), damping4);
+        _mm_storeu_ps(vx + i, velX);
+        _mm_storeu_ps(vy + i, velY);
+
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, dt4)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, dt4)));
+
+        __m128 remaining = _mm_sub_ps(_mm_loadu_ps(life + i), dt4);
+        _mm_storeu_ps(life + i, remaining);
+
+        __m128 normalized = _mm_sub_ps(one4, _mm_mul_ps(remaining, _mm_loadu_ps(inverseLifetime + i)));
+        _mm_storeu_ps(age + i, _mm_min_ps(_mm_max_ps(normalized, zero4), one4));
+    }
+#endif
+
+    for (; i < mCount; ++i) {
+        vx[i] = (vx[i] + gravityX) * damping;
+        vy[i] = (vy[i] + gravityY) * damping;
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        life[i] -= deltaTime;
+        age[i] = Math::Clamp(1.0f - life[i] * inverseLifetime[i], 0.0f, 1.0f);
+    }
+}
+
+void ParticleSystemComponent::RemoveDead() {
+    int i = 0;
+    while (i < mCount) {
+        if (mLife[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+
+        int last = --mCount;
+        mPositionX[i] = mPositionX[last];
+        mPositionY[i] = mPositionY[last];
+        mVelocityX[i] = mVelocityX[last];
+        mVelocityY[i] = mVelocityY[last];
+        mLife[i] = mLife[last];
+        mInverseLifetime[i] = mInverseLifetime[last];
+        mAge[i] = mAge[last];
+    }
+}
+
+int ParticleSystemComponent::GetColorStep(int index) const {
+    return Math::Min(static_cast<int>(mAge[index] * ColorSteps), ColorSteps - 1);
+}
+
+void ParticleSystemComponent::Draw(SDL_Renderer* renderer) {
+    if (mCount == 0) {
+        return;
+    }
+
+    // Counting sort by colour step so each step is one contiguous batch.
+    int counts[ColorSteps] = {};
+    for (int i = 0; i < mCount; ++i) {
+        ++counts[GetColorStep(i)];
+    }
+
+    int offsets[ColorSteps];
+    int next[ColorSteps];
+    int sizes[ColorSteps];
+    int total = 0;
+    int pixels = 0;
+    for (int step = 0; step < ColorSteps; ++step) {
+        offsets[step] = total;
+        next[step] = total;
+        total += counts[step];
+
+        float t = static_cast<float>(step) / (ColorSteps - 1);
+        sizes[step] = Math::Max(static_cast<int>(Math::Lerp(mStartSize, mEndSize, t)), 1);
+        pixels += counts[step] * sizes[step] * sizes[step];
+    }
+
+    for (int i = 0; i < mCount; ++i) {
+        int step = GetColorStep(i);
+        int size = sizes[step];
+
+        SDL_Rect& r = mRects[next[step]++];
+        r.x = static_cast<int>(mPositionX[i]) - size / 2;
+        r.y = static_cast<int>(mPositionY[i]) - size / 2;
+        r.w = size;
+        r.h = size;
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    for (int step = 0; step < ColorSteps; ++step) {
+        if (counts[step] == 0) {
+            continue;
+        }
+
+        float t = (step + 0.5f) / ColorSteps;
+        Vector3 color = Vector3::Lerp(mStartColor, mEndColor, t);
+        float alpha = Math::Lerp(mStartAlpha, mEndAlpha, t);
+
+        SDL_SetRenderDrawColor(renderer,
+                               static_cast<Uint8>(color.x * 255.0f),
+                               static_cast<Uint8>(color.y * 255.0f),
+                               static_cast<Uint8>(color.z * 255.0f),
+                               static_cast<Uint8>(alpha * 255.0f));
+        SDL_RenderFillRects(renderer, mRects.data() + offsets[step], counts[step]);
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    mOwner->GetGame()->GetStats().AddFill(GetDrawOrder(), pixels);
+}
+
+float ParticleSystemComponent::Random() {
+    // xorshift32: cheap and allocation free, good enough for visual noise.
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+    return (mRandomState >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,128 @@
+#ifndef PARTICLE_SYSTEM_COMPONENT_H
+#define PARTICLE_SYSTEM_COMPONENT_H
+
+#include "Math.h"
+#include "SpriteComponent.h"
+
+#include <vector>
+
+// Emitter whose particles live in structure-of-arrays buffers sized once for
+// the particle budget. Dead particles are recycled in place, so emitting and
+// updating never allocate. Colour and size are functions of normalized age,
+// which lets Draw submit one SDL_RenderFillRects batch per colour step.
+class ParticleSystemComponent : public SpriteComponent {
+public:
+    ParticleSystemComponent(class Actor* owner, int maxParticles, int drawOrder = 90);
+
+    void Update(float deltaTime) override;
+    void Draw(SDL_Renderer* renderer) override;
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+
+    // Spawns up to count particles immediately, e.g. for an explosion.
+    void Burst(int count);
+
+    void SetEmitOffset(const Vector2& offset) {
+        mEmitOffset = offset;
+    }
+
+    void SetEmitRate(float particlesPerSecond) {
+        mEmitRate = particlesPerSecond;
+    }
+
+    // Direction in radians (0 points along +x, screen space) and half-angle of the cone.
+    void SetDirection(float angle, float spread) {
+        mDirection = angle;
+        mSpread = spread;
+    }
+
+    void SetSpeed(float minSpeed, float maxSpeed) {
+        mMinSpeed = minSpeed;
+        mMaxSpeed = maxSpeed;
+    }
+
+    void SetLifetime(float minLifetime, float maxLifetime) {
+        mMinLifetime = minLifetime;
+        mMaxLifetime = maxLifetime;
+    }
+
+    void SetGravity(const Vector2& gravity) {
+        mGravity = gravity;
+    }
+
+    void SetDrag(float drag) {
+        mDrag = drag;
+    }
+
+    // RGBA in 0..1, interpolated from start to end over each particle's life.
+    void SetColors(const Vector3& startColor, float startAlpha, const Vector3& endColor, float endAlpha) {
+        mStartColor = startColor;
+        mStartAlpha = startAlpha;
+        mEndColor = endColor;
+        mEndAlpha = endAlpha;
+    }
+
+    void SetSizes(float startSize, float endSize) {
+        mStartSize = startSize;
+        mEndSize = endSize;
+    }
+
+    // Fraction of the particle budget that may be alive; lowered by quality scaling.
+    void SetBudgetScale(float scale) {
+        mBudgetScale = Math::Clamp(scale, 0.0f, 1.0f);
+    }
+
+    int GetParticleCount() const {
+        return mCount;
+    }
+
+    int GetMaxParticles() const {
+        return mMaxParticles;
+    }
+
+private:
+    static const int ColorSteps = 8;
+
+    void Emit(int count);
+    void Simulate(float deltaTime);
+    void RemoveDead();
+    int GetColorStep(int index) const;
+    float Random();
+
+    int mMaxParticles;
+    int mCount;
+
+    std::vector<float> mPositionX;
+    std::vector<float> mPositionY;
+    std::vector<float> mVelocityX;
+    std::vector<float> mVelocityY;
+    std::vector<float> mLife;
+    std::vector<float> mInverseLifetime;
+    std::vector<float> mAge;
+
+    // Draw rectangles grouped by colour step, rebuilt every frame.
+    std::vector<SDL_Rect> mRects;
+
+    Vector2 mEmitOffset;
+    float mEmitRate;
+    float mEmitAccumulator;
+    float mDirection;
+    float mSpread;
+    float mMinSpeed;
+    float mMaxSpeed;
+    float mMinLifetime;
+    float mMaxLifetime;
+    Vector2 mGravity;
+    float mDrag;
+    Vector3 mStartColor;
+    float mStartAlpha;
+    Vector3 mEndColor;
+    float mEndAlpha;
+    float mStartSize;
+    float mEndSize;
+    float mBudgetScale;
+
+    unsigned int mRandomState;
+};
+
+#endif // PARTICLE_SYSTEM_COMPONENT_H
@@ -0,0 +1,90 @@
+#include "QualityGovernor.h"
+
+#include "SDL.h"
+
+#include <algorithm>
+
+namespace {
+    const QualitySettings Levels[QualityGovernor::NumLevels] = {
+        // layers, animation rate, particle budget, off-screen divisor
+        { 8, 1.0f, 1.0f, 1 },
+        { 8, 1.0f, 0.5f, 2 },
+        { 8, 0.5f, 0.5f, 4 },
+        { 1, 0.5f, 0.25f, 4 },
+        { 1, 0.25f, 0.1f, 8 }
+    };
+
+    const int EvaluationInterval = 30;
+    // Raise quality only when p95 has stayed under this fraction of the budget for a while.
+    const float HeadroomFraction = 0.6f;
+    const int HeadroomEvaluations = 3;
+}
+
+QualityGovernor::QualityGovernor()
+    : mWindowCount(0)
+    , mWindowNext(0)
+    , mFramesSinceEvaluation(0)
+    , mHeadroomEvaluations(0)
+    , mBudgetMs(12.0f)
+    , mLevel(0) {
+}
+
+const QualitySettings& QualityGovernor::GetSettings() const {
+    return Levels[mLevel];
+}
+
+bool QualityGovernor::AddFrame(float workMs, std::uint64_t frameNumber) {
+    mWindow[mWindowNext] = workMs;
+    mWindowNext = (mWindowNext + 1) % WindowSize;
+    mWindowCount = std::min(mWindowCount + 1, WindowSize);
+
+    if (++mFramesSinceEvaluation < EvaluationInterval || mWindowCount < WindowSize) {
+        return false;
+    }
+    mFramesSinceEvaluation = 0;
+
+    float sorted[WindowSize];
+    std::copy(mWindow, mWindow + WindowSize, sorted);
+    std::sort(sorted, sorted + WindowSize);
+    float p50 = sorted[WindowSize / 2];
+    float p95 = sorted[WindowSize * 95 / 100];
+
+    if (p95 > mBudgetMs && mLevel < NumLevels - 1) {
+        mHeadroomEvaluations = 0;
+        SetLevel(mLevel + 1, p50, p95, frameNumber);
+        return true;
+    }
+
+    if (p95 < mBudgetMs * HeadroomFraction && mLevel > 0) {
+        if (++mHeadroomEvaluations >= HeadroomEvaluations) {
+            mHeadroomEvaluations = 0;
+            SetLevel(mLevel - 1, p50, p95, frameNumber);
+            return true;
+        }
+    } else {
+        mHeadroomEvaluations = 0;
+    }
+
+    return false;
+}
+
+void QualityGovernor::SetLevel(int level, float p50, float p95, std::uint64_t frameNumber) {
+    const QualitySettings& settings = Levels[level];
+    SDL_Log("Quality %d -> %d at frame %u: work p50 %.3f / p95 %.3f ms, budget %.3f ms "
+            "(layers %d, animation %.2f, particles %.2f, off-screen 1/%d)",
+            mLevel,
+            level,
+            static_cast<unsigned int>(frameNumber),
+            p50,
+            p95,
+            mBudgetMs,
+            settings.mBackgroundLayers,
+            settings.mAnimationRate,
+            settings.mParticleBudget,
+            settings.mOffscreenUpdateDivisor);
+
+    mLevel = level;
+    // Judge the new level on frames rendered with it only.
+    mWindowCount = 0;
+    mWindowNext = 0;
+}
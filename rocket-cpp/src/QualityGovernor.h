@@ -0,0 +1,56 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <cstdint>
+
+// Optional work that may be reduced when frames run over budget.
+struct QualitySettings {
+    // Background layers whose rank is below this are drawn.
+    int mBackgroundLayers;
+    // Fraction of the clip's frame rate at which animations change frames.
+    float mAnimationRate;
+    // Fraction of each particle system's budget that may be alive.
+    float mParticleBudget;
+    // Off-screen actors update on one tick in this many, with the skipped time folded in.
+    // Game uses the larger of this and its own update level of detail divisor.
+    int mOffscreenUpdateDivisor;
+};
+
+// Watches a rolling window of per-frame work time (excluding present and pacing waits)
+// and steps through quality levels: down as soon as p95 exceeds the budget, back up
+// only after sustained headroom.
+class QualityGovernor {
+public:
+    static const int NumLevels = 5;
+
+    QualityGovernor();
+
+    void SetBudget(float workBudgetMs) {
+        mBudgetMs = workBudgetMs;
+    }
+
+    // Returns true when the level changed; the decision is logged with the numbers behind it.
+    bool AddFrame(float workMs, std::uint64_t frameNumber);
+
+    int GetLevel() const {
+        return mLevel;
+    }
+
+    const QualitySettings& GetSettings() const;
+
+private:
+    static const int WindowSize = 60;
+
+    void SetLevel(int level, float p50, float p95, std::uint64_t frameNumber);
+
+    float mWindow[WindowSize];
+    int mWindowCount;
+    int mWindowNext;
+    int mFramesSinceEvaluation;
+    int mHeadroomEvaluations;
+
+    float mBudgetMs;
+    int mLevel;
+};
+
+#endif // QUALITY_GOVERNOR_H
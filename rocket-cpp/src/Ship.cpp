@@ -1,19 +1,37 @@
 #include "Ship.h"
+#include "ActionMap.h"
 #include "AnimatedSpriteComponent.h"
 #include "Game.h"
+#include "ParticleSystemComponent.h"
+#include "WorldSnapshot.h"
+
+namespace {
+    const float HorizontalSpeed = 250.0f;
+    const float VerticalSpeed = 300.0f;
+}
 
 Ship::Ship(Game* game)
     : Actor(game)
     , mHorizontalSpeed(0.0f)
-    , mVerticalSpeed(0.0f) {
-    AnimatedSpriteComponent* animatedSpriteComponent = new AnimatedSpriteComponent(this);
-    std::vector<SDL_Texture*> animationTextures = {
-        game->GetTexture("assets/rocket1.png"),
-        game->GetTexture("assets/rocket2.png"),
-        game->GetTexture("assets/rocket3.png")
-    };
+    , mVerticalSpeed(0.0f)
+    , mLatched(false) {
+    AnimatedSpriteComponent* animatedSpriteComponent = CreateComponent<AnimatedSpriteComponent>();
+    const AnimationClip* clip = game->GetPackedAnimationClip("rocket",
+                                                             { "assets/rocket1.png",
+                                                               "assets/rocket2.png",
+                                                               "assets/rocket3.png" },
+                                                             24.0f);
 
-    animatedSpriteComponent->SetAnimationTextures(animationTextures);
+    animatedSpriteComponent->SetAnimationClip(clip);
+
+    ParticleSystemComponent* exhaust = CreateComponent<ParticleSystemComponent>(2000);
+    exhaust->SetEmitOffset(Vector2(-100.0f, 0.0f));
+    exhaust->SetEmitRate(600.0f);
+    exhaust->SetDirection(Math::Pi, 0.25f);
+    exhaust->SetSpeed(200.0f, 350.0f);
+    exhaust->SetLifetime(0.2f, 0.5f);
+    exhaust->SetColors(Color::LightYellow, 1.0f, Color::Red, 0.0f);
+    exhaust->SetSizes(8.0f, 2.0f);
 }
 
 void Ship::UpdateActor(float deltaTime) {
@@ -23,6 +41,56 @@ void Ship::UpdateActor(float deltaTime) {
     pos.x += mHorizontalSpeed * deltaTime;
     pos.y += mVerticalSpeed * deltaTime;
 
+    SetPosition(ClampToScreen(pos));
+}
+
+void Ship::ProcessActions(const ActionMap& actions) {
+    mHorizontalSpeed = HorizontalSpeed * (actions.GetHeldFraction(ActionMap::EMoveRight) -
+                                          actions.GetHeldFraction(ActionMap::EMoveLeft));
+    mVerticalSpeed = VerticalSpeed * (actions.GetHeldFraction(ActionMap::EMoveDown) -
+                                      actions.GetHeldFraction(ActionMap::EMoveUp));
+}
+
+void Ship::LateLatch(const ActionMap& actions, float deltaTime) {
+    if (!mLatched) {
+        mLatchedFrom = GetPosition();
+        mLatched = true;
+    }
+
+    Vector2 pos = mLatchedFrom;
+    pos.x += HorizontalSpeed * deltaTime * (actions.GetHeldFraction(ActionMap::EMoveRight) -
+                                            actions.GetHeldFraction(ActionMap::EMoveLeft));
+    pos.y += VerticalSpeed * deltaTime * (actions.GetHeldFraction(ActionMap::EMoveDown) -
+                                          actions.GetHeldFraction(ActionMap::EMoveUp));
+
+    SetPosition(ClampToScreen(pos));
+}
+
+void Ship::UndoLateLatch() {
+    if (mLatched) {
+        SetPosition(mLatchedFrom);
+        mLatched = false;
+    }
+}
+
+void Ship::SaveState(SnapshotWriter& writer) const {
+    Actor::SaveState(writer);
+    writer.Write(mHorizontalSpeed);
+    writer.Write(mVerticalSpeed);
+    writer.Write(mLatchedFrom);
+    writer.Write(mLatched);
+}
+
+void Ship::LoadState(SnapshotReader& reader) {
+    Actor::LoadState(reader);
+    reader.Read(mHorizontalSpeed);
+    reader.Read(mVerticalSpeed);
+    reader.Read(mLatchedFrom);
+    reader.Read(mLatched);
+}
+
+Vector2 Ship::ClampToScreen(const Vector2& position) const {
+    Vector2 pos = position;
     float scale = GetScale();
 
     if (pos.x < 262.0f * scale) {
@@ -37,26 +105,5 @@ void Ship::UpdateActor(float deltaTime) {
         pos.y = 720.0f - 150.0f * scale;
     }
 
-    SetPosition(pos);
-}
-
-void Ship::ProcessKeyboard(const std::uint8_t* state) {
-    mHorizontalSpeed = 0.0f;
-    mVerticalSpeed = 0.0f;
-
-    if (state[SDL_SCANCODE_D]) {
-        mHorizontalSpeed += 250.0f;
-    }
-
-    if (state[SDL_SCANCODE_A]) {
-        mHorizontalSpeed -= 250.0f;
-    }
-
-    if (state[SDL_SCANCODE_S]) {
-        mVerticalSpeed += 300.0f;
-    }
-
-    if (state[SDL_SCANCODE_W]) {
-        mVerticalSpeed -= 300.0f;
-    }
+    return pos;
 }
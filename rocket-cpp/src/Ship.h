@@ -7,7 +7,15 @@ class Ship : public Actor {
 public:
     Ship(class Game* game);
     void UpdateActor(float deltaTime) override;
-    void ProcessKeyboard(const std::uint8_t* state);
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+    // Speeds for the coming tick, scaled by how long each direction was held during it.
+    void ProcessActions(const class ActionMap& actions);
+
+    // Moves the ship by the input that arrived after the last tick, for display only.
+    // UndoLateLatch puts it back before the next tick simulates that input for real.
+    void LateLatch(const class ActionMap& actions, float deltaTime);
+    void UndoLateLatch();
 
     float GetHorizontalSpeed() const {
         return mHorizontalSpeed;
@@ -18,8 +26,13 @@ public:
     }
 
 private:
+    Vector2 ClampToScreen(const Vector2& position) const;
+
     float mHorizontalSpeed;
     float mVerticalSpeed;
+
+    Vector2 mLatchedFrom;
+    bool mLatched;
 };
 
 #endif // SHIP_H
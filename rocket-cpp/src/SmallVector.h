@@ -0,0 +1,223 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// Vector of trivially copyable values that keeps up to N of them inside the
+// object and only allocates once it grows past that. For the short per-object
+// lists (an actor's components, a clip's frames) that almost never exceed a
+// handful of entries. Iterators are plain pointers and are invalidated by any
+// insertion, like std::vector's.
+template <typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector moves elements with memcpy");
+    static_assert(N > 0, "SmallVector needs inline capacity");
+
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    SmallVector()
+        : mData(reinterpret_cast<T*>(mInline))
+        , mSize(0)
+        , mCapacity(N) {
+    }
+
+    SmallVector(const SmallVector& other)
+        : SmallVector() {
+        Append(other.mData, other.mSize);
+    }
+
+    SmallVector(SmallVector&& other)
+        : SmallVector() {
+        MoveFrom(other);
+    }
+
+    ~SmallVector() {
+        if (!IsInline()) {
+            ::operator delete(mData);
+        }
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            mSize = 0;
+            Append(other.mData, other.mSize);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) {
+        if (this != &other) {
+            mSize = 0;
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    iterator begin() {
+        return mData;
+    }
+
+    iterator end() {
+        return mData + mSize;
+    }
+
+    const_iterator begin() const {
+        return mData;
+    }
+
+    const_iterator end() const {
+        return mData + mSize;
+    }
+
+    T* data() {
+        return mData;
+    }
+
+    const T* data() const {
+        return mData;
+    }
+
+    std::size_t size() const {
+        return mSize;
+    }
+
+    std::size_t capacity() const {
+        return mCapacity;
+    }
+
+    bool empty() const {
+        return mSize == 0;
+    }
+
+    // True while the elements still live inside the object.
+    bool IsInline() const {
+        return mData == reinterpret_cast<const T*>(mInline);
+    }
+
+    T& operator[](std::size_t index) {
+        return mData[index];
+    }
+
+    const T& operator[](std::size_t index) const {
+        return mData[index];
+    }
+
+    T& front() {
+        return mData[0];
+    }
+
+    const T& front() const {
+        return mData[0];
+    }
+
+    T& back() {
+        return mData[mSize - 1];
+    }
+
+    const T& back() const {
+        return mData[mSize - 1];
+    }
+
+    void reserve(std::size_t capacity) {
+        if (capacity > mCapacity) {
+            Reallocate(capacity);
+        }
+    }
+
+    void clear() {
+        mSize = 0;
+    }
+
+    void push_back(const T& value) {
+        // Copy first: value may refer to an element that Grow is about to free.
+        T copy = value;
+        if (mSize == mCapacity) {
+            Grow();
+        }
+        mData[mSize++] = copy;
+    }
+
+    void emplace_back(const T& value) {
+        push_back(value);
+    }
+
+    void pop_back() {
+        --mSize;
+    }
+
+    iterator insert(const_iterator position, const T& value) {
+        std::size_t index = static_cast<std::size_t>(position - mData);
+        T copy = value;
+        if (mSize == mCapacity) {
+            Grow();
+        }
+
+        std::memmove(mData + index + 1, mData + index, (mSize - index) * sizeof(T));
+        mData[index] = copy;
+        ++mSize;
+        return mData + index;
+    }
+
+    iterator erase(const_iterator position) {
+        std::size_t index = static_cast<std::size_t>(position - mData);
+        std::memmove(mData + index, mData + index + 1, (mSize - index - 1) * sizeof(T));
+        --mSize;
+        return mData + index;
+    }
+
+private:
+    void Grow() {
+        Reallocate(mCapacity * 2);
+    }
+
+    void Reallocate(std::size_t capacity) {
+        T* data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        if (mSize > 0) {
+            std::memcpy(data, mData, mSize * sizeof(T));
+        }
+        if (!IsInline()) {
+            ::operator delete(mData);
+        }
+
+        mData = data;
+        mCapacity = capacity;
+    }
+
+    void Append(const T* values, std::size_t count) {
+        reserve(mSize + count);
+        if (count > 0) {
+            std::memcpy(mData + mSize, values, count * sizeof(T));
+        }
+        mSize += count;
+    }
+
+    // Takes other's contents, leaving it empty. Expects this to be empty.
+    void MoveFrom(SmallVector& other) {
+        if (other.IsInline()) {
+            Append(other.mData, other.mSize);
+        } else {
+            if (!IsInline()) {
+                ::operator delete(mData);
+            }
+            mData = other.mData;
+            mCapacity = other.mCapacity;
+            mSize = other.mSize;
+            other.mData = reinterpret_cast<T*>(other.mInline);
+            other.mCapacity = N;
+        }
+        other.mSize = 0;
+    }
+
+    T* mData;
+    std::size_t mSize;
+    std::size_t mCapacity;
+    alignas(T) unsigned char mInline[N * sizeof(T)];
+};
+
+#endif // SMALL_VECTOR_H
@@ -1,13 +1,16 @@
 #include "SpriteComponent.h"
 #include "Actor.h"
 #include "Game.h"
+#include "WorldSnapshot.h"
 
 SpriteComponent::SpriteComponent(Actor* owner, int drawOrder)
     : Component(owner)
     , mTexture(nullptr)
     , mDrawOrder(drawOrder)
     , mTextureWidth(0)
-    , mTextureHeight(0) {
+    , mTextureHeight(0)
+    , mSourceRect()
+    , mHasSourceRect(false) {
     mOwner->GetGame()->AddSprite(this);
 }
 
@@ -26,15 +29,42 @@ void SpriteComponent::Draw(SDL_Renderer* renderer) {
 
         SDL_RenderCopyEx(renderer,
                          mTexture,
-                         nullptr,
+                         GetSourceRect(),
                          &r,
                          static_cast<double>(-Math::ToDegrees(mOwner->GetRotation())),
                          nullptr,
                          SDL_FLIP_NONE);
+
+        mOwner->GetGame()->GetStats().AddFill(mDrawOrder, r.w * r.h);
     }
 }
 
 void SpriteComponent::SetTexture(SDL_Texture* texture) {
     mTexture = texture;
+    mHasSourceRect = false;
     SDL_QueryTexture(texture, nullptr, nullptr, &mTextureWidth, &mTextureHeight);
 }
+
+void SpriteComponent::SetTextureRegion(SDL_Texture* texture, const SDL_Rect& source) {
+    mTexture = texture;
+    mSourceRect = source;
+    mHasSourceRect = true;
+    mTextureWidth = source.w;
+    mTextureHeight = source.h;
+}
+
+void SpriteComponent::SaveState(SnapshotWriter& writer) const {
+    writer.Write(mTexture);
+    writer.Write(mTextureWidth);
+    writer.Write(mTextureHeight);
+    writer.Write(mSourceRect);
+    writer.Write(mHasSourceRect);
+}
+
+void SpriteComponent::LoadState(SnapshotReader& reader) {
+    reader.Read(mTexture);
+    reader.Read(mTextureWidth);
+    reader.Read(mTextureHeight);
+    reader.Read(mSourceRect);
+    reader.Read(mHasSourceRect);
+}
@@ -12,6 +12,12 @@ public:
 
     virtual void Draw(SDL_Renderer* renderer);
     virtual void SetTexture(SDL_Texture* texture);
+    // Draws only the source rectangle of texture, e.g. one cell of a sprite sheet.
+    // The sprite takes the size of the rectangle and no SDL_QueryTexture is made.
+    void SetTextureRegion(SDL_Texture* texture, const SDL_Rect& source);
+
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
 
     int GetDrawOrder() const {
         return mDrawOrder;
@@ -25,11 +31,17 @@ public:
         return mTextureHeight;
     }
 
+    const SDL_Rect* GetSourceRect() const {
+        return mHasSourceRect ? &mSourceRect : nullptr;
+    }
+
 protected:
     SDL_Texture* mTexture;
     int mDrawOrder;
     int mTextureWidth;
     int mTextureHeight;
+    SDL_Rect mSourceRect;
+    bool mHasSourceRect;
 };
 
 #endif // SPRITE_COMPONENT_H
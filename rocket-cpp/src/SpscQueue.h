@@ -0,0 +1,146 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity lock-free queue for exactly one producer thread and one
+// consumer thread. Capacity must be a power of two; one slot is kept free.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue()
+        : mHead(0)
+        , mTail(0) {
+    }
+
+    // Producer side. Returns false when the queue is full.
+    bool Push(const T& value) {
+        std::size_t tail = mTail.load(std::memory_order_relaxed);
+        std::size_t next = (tail + 1) & (Capacity - 1);
+        if (next == mHead.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        mItems[tail] = value;
+        mTail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool Pop(T& value) {
+        std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = mItems[head];
+        mHead.store((head + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Looks at the oldest item without removing it.
+    const T* Peek() const {
+        std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        return &mItems[head];
+    }
+
+    bool IsEmpty() const {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+
+private:
+    static const std::size_t CacheLine = 64;
+
+    T mItems[Capacity];
+    // Head and tail sit on separate cache lines so producer and consumer do not
+    // contend on the same line. Padding rather than alignas, which plain new does
+    // not honour before C++17, so queues can live in heap-allocated objects.
+    char mHeadPadding[CacheLine];
+    std::atomic<std::size_t> mHead;
+    char mTailPadding[CacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> mTail;
+    char mEndPadding[CacheLine - sizeof(std::atomic<std::size_t>)];
+};
+
+// Lock-free ring of samples for one producer thread and one consumer thread.
+// Storage is allocated once at construction; capacity is rounded up to a power of two.
+template <typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(std::size_t capacity)
+        : mReadIndex(0)
+        , mWriteIndex(0) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mItems.resize(size);
+        mMask = size - 1;
+    }
+
+    std::size_t GetCapacity() const {
+        return mItems.size();
+    }
+
+    std::size_t GetReadAvailable() const {
+        return mWriteIndex.load(std::memory_order_acquire) - mReadIndex.load(std::memory_order_acquire);
+    }
+
+    std::size_t GetWriteAvailable() const {
+        return mItems.size() - GetReadAvailable();
+    }
+
+    // Producer side. Returns the number of items actually written.
+    std::size_t Write(const T* items, std::size_t count) {
+        std::size_t write = mWriteIndex.load(std::memory_order_relaxed);
+        std::size_t space = mItems.size() - (write - mReadIndex.load(std::memory_order_acquire));
+        count = std::min(count, space);
+
+        std::size_t start = write & mMask;
+        std::size_t first = std::min(count, mItems.size() - start);
+        std::copy(items, items + first, mItems.begin() + start);
+        std::copy(items + first, items + count, mItems.begin());
+
+        mWriteIndex.store(write + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side. Returns the number of items actually read.
+    std::size_t Read(T* items, std::size_t count) {
+        std::size_t read = mReadIndex.load(std::memory_order_relaxed);
+        std::size_t available = mWriteIndex.load(std::memory_order_acquire) - read;
+        count = std::min(count, available);
+
+        std::size_t start = read & mMask;
+        std::size_t first = std::min(count, mItems.size() - start);
+        std::copy(mItems.begin() + start, mItems.begin() + start + first, items);
+        std::copy(mItems.begin(), mItems.begin() + (count - first), items + first);
+
+        mReadIndex.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    static const std::size_t CacheLine = 64;
+
+    std::vector<T> mItems;
+    std::size_t mMask;
+    // Monotonic counters; only the low bits index the storage. Padded onto separate
+    // cache lines like SpscQueue's head and tail.
+    char mReadPadding[CacheLine];
+    std::atomic<std::size_t> mReadIndex;
+    char mWritePadding[CacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> mWriteIndex;
+    char mEndPadding[CacheLine - sizeof(std::atomic<std::size_t>)];
+};
+
+#endif // SPSC_QUEUE_H
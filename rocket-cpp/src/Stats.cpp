@@ -0,0 +1,365 @@
+#include "Stats.h"
+#include "AllocationCounter.h"
+
+#include <algorithm>
+
+namespace {
+    const float LatencyBucketLimitsMs[Stats::LatencyBuckets - 1] = { 8.0f, 16.0f, 33.0f, 50.0f };
+    const char* const LatencyBucketNames[Stats::LatencyBuckets] = {
+        "latency_0_8ms",
+        "latency_8_16ms",
+        "latency_16_33ms",
+        "latency_33_50ms",
+        "latency_50ms_up"
+    };
+
+    // Refresh at least this often even when frames are very short, e.g. in headless runs.
+    const int MaxFramesBetweenRefreshes = 32;
+
+    const char* const PhaseNames[Stats::ENumPhases] = {
+        "input",
+        "update",
+        "output"
+    };
+}
+
+Stats::Stats()
+    : mFrameCount(0)
+    , mFrameStart(0)
+    , mAllocationsAtFrameStart(0)
+    , mHistoryCount(0)
+    , mHistoryNext(0)
+    , mSinceRefreshMs(0.0f)
+    , mFramesSinceRefresh(0)
+    , mPercentile50(0.0f)
+    , mPercentile95(0.0f)
+    , mPercentile99(0.0f)
+    , mSummaryRefreshed(false)
+    , mFillLayerCount(0)
+    , mFillScale(1.0f)
+    , mLoggedFillLayers(-1)
+    , mRecentInputLatencyMs(0.0f)
+    , mLogFile(nullptr)
+    , mLogJson(false)
+    , mLogHeaderWritten(false)
+    , mOverlayEnabled(false) {
+    mCurrent = Frame();
+    mCurrent.mRenderScale = 1.0f;
+    mLast = mCurrent;
+    mSummary[0] = '\0';
+    mTicksToMs = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+
+    for (int i = 0; i < ENumPhases; ++i) {
+        mPhaseStart[i] = 0;
+        for (int j = 0; j < HardwareCounters::ENumCounters; ++j) {
+            mPhaseCountersStart[i][j] = 0;
+        }
+    }
+}
+
+Stats::~Stats() {
+    CloseLog();
+}
+
+bool Stats::OpenLog(const std::string& fileName) {
+    CloseLog();
+
+    mLogFile = std::fopen(fileName.c_str(), "w");
+    if (!mLogFile) {
+        SDL_Log("Failed to open stats log %s", fileName.c_str());
+        return false;
+    }
+
+    std::string::size_type dot = fileName.find_last_of('.');
+    std::string extension = dot == std::string::npos ? "" : fileName.substr(dot);
+    mLogJson = extension == ".json" || extension == ".jsonl";
+    mLogHeaderWritten = false;
+
+    return true;
+}
+
+void Stats::CloseLog() {
+    if (mLogFile) {
+        std::fclose(mLogFile);
+        mLogFile = nullptr;
+    }
+}
+
+void Stats::BeginFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (mFrameStart != 0) {
+        mCurrent.mFrameMs = static_cast<float>((now - mFrameStart) * mTicksToMs);
+    }
+    mFrameStart = now;
+
+    for (int i = 0; i < ENumPhases; ++i) {
+        mCurrent.mPhaseMs[i] = 0.0f;
+        for (int j = 0; j < HardwareCounters::ENumCounters; ++j) {
+            mCurrent.mPhaseCounters[i][j] = 0;
+        }
+    }
+
+    mCurrent.mPresentMs = 0.0f;
+    mCurrent.mPacingMs = 0.0f;
+    mCurrent.mTextureLoads = 0;
+    mCurrent.mInputEvents = 0;
+    mCurrent.mInputLatencyMs = 0.0f;
+    for (int i = 0; i < LatencyBuckets; ++i) {
+        mCurrent.mInputLatencyHistogram[i] = 0;
+    }
+
+    mCurrent.mFillPixels = 0;
+    for (int i = 0; i < mFillLayerCount; ++i) {
+        mFillLayerPixels[i] = 0;
+    }
+
+    mAllocationsAtFrameStart = AllocationCounter::GetCount();
+}
+
+void Stats::EndFrame() {
+    mCurrent.mAllocations = AllocationCounter::GetCount() - mAllocationsAtFrameStart;
+
+    mHistory[mHistoryNext] = mCurrent.mFrameMs;
+    mHistoryNext = (mHistoryNext + 1) % HistorySize;
+    mHistoryCount = std::min(mHistoryCount + 1, HistorySize);
+
+    mSummaryRefreshed = false;
+    mSinceRefreshMs += mCurrent.mFrameMs;
+    ++mFramesSinceRefresh;
+    if (mSinceRefreshMs >= 500.0f || mFramesSinceRefresh >= MaxFramesBetweenRefreshes) {
+        RefreshSummary();
+        mSinceRefreshMs = 0.0f;
+        mFramesSinceRefresh = 0;
+    }
+
+    if (mLogFile) {
+        WriteLogLine();
+    }
+
+    mLast = mCurrent;
+    ++mFrameCount;
+}
+
+void Stats::BeginPhase(Phase phase) {
+    if (mCounters.IsOpen()) {
+        mCounters.Read(mPhaseCountersStart[phase]);
+    }
+    mPhaseStart[phase] = SDL_GetPerformanceCounter();
+}
+
+void Stats::EndPhase(Phase phase) {
+    Uint64 elapsed = SDL_GetPerformanceCounter() - mPhaseStart[phase];
+    mCurrent.mPhaseMs[phase] += static_cast<float>(elapsed * mTicksToMs);
+
+    if (mCounters.IsOpen()) {
+        std::uint64_t counters[HardwareCounters::ENumCounters];
+        mCounters.Read(counters);
+        for (int i = 0; i < HardwareCounters::ENumCounters; ++i) {
+            // Multiplexing estimates can step backwards slightly.
+            if (counters[i] > mPhaseCountersStart[phase][i]) {
+                mCurrent.mPhaseCounters[phase][i] += counters[i] - mPhaseCountersStart[phase][i];
+            }
+        }
+    }
+}
+
+bool Stats::EnableHardwareCounters() {
+    return mCounters.Open();
+}
+
+void Stats::AddFill(int drawOrder, int logicalPixels) {
+    std::uint64_t pixels = static_cast<std::uint64_t>(logicalPixels * mFillScale + 0.5f);
+    mCurrent.mFillPixels += pixels;
+
+    for (int i = 0; i < mFillLayerCount; ++i) {
+        if (mFillLayerOrder[i] == drawOrder) {
+            mFillLayerPixels[i] += pixels;
+            return;
+        }
+    }
+
+    if (mFillLayerCount < MaxFillLayers) {
+        mFillLayerOrder[mFillLayerCount] = drawOrder;
+        mFillLayerPixels[mFillLayerCount] = pixels;
+        ++mFillLayerCount;
+    }
+}
+
+void Stats::AddInputLatency(Uint64 inputTimestamp, Uint64 presentTimestamp) {
+    Uint64 elapsed = presentTimestamp > inputTimestamp ? presentTimestamp - inputTimestamp : 0;
+    float ms = static_cast<float>(elapsed * mTicksToMs);
+
+    int bucket = 0;
+    while (bucket < LatencyBuckets - 1 && ms >= LatencyBucketLimitsMs[bucket]) {
+        ++bucket;
+    }
+
+    ++mCurrent.mInputEvents;
+    ++mCurrent.mInputLatencyHistogram[bucket];
+    mCurrent.mInputLatencyMs = std::max(mCurrent.mInputLatencyMs, ms);
+    mRecentInputLatencyMs = std::max(mRecentInputLatencyMs, ms);
+}
+
+void Stats::RefreshSummary() {
+    float sorted[HistorySize];
+    std::copy(mHistory, mHistory + mHistoryCount, sorted);
+
+    auto percentile = [&](float fraction) {
+        int index = static_cast<int>(fraction * (mHistoryCount - 1) + 0.5f);
+        std::nth_element(sorted, sorted + index, sorted + mHistoryCount);
+        return sorted[index];
+    };
+
+    mPercentile50 = percentile(0.50f);
+    mPercentile95 = percentile(0.95f);
+    mPercentile99 = percentile(0.99f);
+
+    std::snprintf(mSummary, sizeof(mSummary),
+                 "%.1f ms p50 / %.1f p95 / %.1f p99 | present %.1f + wait %.1f ms | actors %d (+%d) | sprites %d | fill %.2f Mpx @ %.2f | textures %d | allocs %u | audio %.2f ms | input %.1f ms",
+                 mPercentile50,
+                 mPercentile95,
+                 mPercentile99,
+                 mCurrent.mPresentMs,
+                 mCurrent.mPacingMs,
+                 mCurrent.mActors,
+                 mCurrent.mPendingActors,
+                 mCurrent.mSpritesDrawn,
+                 mCurrent.mFillPixels / 1e6,
+                 mCurrent.mRenderScale,
+                 mCurrent.mTextures,
+                 static_cast<unsigned int>(mCurrent.mAllocations),
+                 mCurrent.mAudioCallbackMaxMs,
+                 mRecentInputLatencyMs);
+
+    mRecentInputLatencyMs = 0.0f;
+
+    mSummaryRefreshed = true;
+}
+
+void Stats::WriteLogLine() {
+    mLogLine.clear();
+
+    WriteField("frame", static_cast<double>(mFrameCount), 0);
+    WriteField("frame_ms", mCurrent.mFrameMs, 3);
+    WriteField("input_ms", mCurrent.mPhaseMs[EInput], 3);
+    WriteField("update_ms", mCurrent.mPhaseMs[EUpdate], 3);
+    WriteField("output_ms", mCurrent.mPhaseMs[EOutput], 3);
+    WriteField("present_ms", mCurrent.mPresentMs, 3);
+    WriteField("pacing_ms", mCurrent.mPacingMs, 3);
+    float workMs = mCurrent.mPhaseMs[EInput] + mCurrent.mPhaseMs[EUpdate] + mCurrent.mPhaseMs[EOutput] - mCurrent.mPresentMs;
+    WriteField("work_ms", workMs, 3);
+    WriteField("render_scale", mCurrent.mRenderScale, 3);
+    WriteField("quality_level", mCurrent.mQualityLevel, 0);
+    WriteField("p50_ms", mPercentile50, 3);
+    WriteField("p95_ms", mPercentile95, 3);
+    WriteField("p99_ms", mPercentile99, 3);
+    WriteField("actors", mCurrent.mActors, 0);
+    WriteField("pending_actors", mCurrent.mPendingActors, 0);
+    WriteField("actor_updates", mCurrent.mActorUpdates, 0);
+    WriteField("sprites_drawn", mCurrent.mSpritesDrawn, 0);
+    WriteField("textures", mCurrent.mTextures, 0);
+    WriteField("texture_loads", mCurrent.mTextureLoads, 0);
+    WriteField("allocations", static_cast<double>(mCurrent.mAllocations), 0);
+    WriteField("fill_pixels", static_cast<double>(mCurrent.mFillPixels), 0);
+    WriteField("audio_callback_ms", mCurrent.mAudioCallbackMs, 3);
+    WriteField("audio_callback_max_ms", mCurrent.mAudioCallbackMaxMs, 3);
+    WriteField("audio_voices", mCurrent.mAudioVoices, 0);
+    WriteField("music_buffered_ms", mCurrent.mMusicBufferedMs, 1);
+    WriteField("music_underruns", mCurrent.mMusicUnderruns, 0);
+    WriteField("input_events", mCurrent.mInputEvents, 0);
+    WriteField("input_latency_ms", mCurrent.mInputLatencyMs, 3);
+    for (int i = 0; i < LatencyBuckets; ++i) {
+        WriteField(LatencyBucketNames[i], mCurrent.mInputLatencyHistogram[i], 0);
+    }
+
+    if (mCounters.IsOpen()) {
+        for (int phase = 0; phase < ENumPhases; ++phase) {
+            for (int i = 0; i < HardwareCounters::ENumCounters; ++i) {
+                HardwareCounters::Counter counter = static_cast<HardwareCounters::Counter>(i);
+                if (mCounters.IsAvailable(counter)) {
+                    char name[48];
+                    std::snprintf(name, sizeof(name), "%s_%s", PhaseNames[phase], HardwareCounters::GetName(counter));
+                    WriteField(name, static_cast<double>(mCurrent.mPhaseCounters[phase][i]), 0);
+                }
+            }
+        }
+    }
+
+    if (mLoggedFillLayers < 0) {
+        mLoggedFillLayers = mFillLayerCount;
+    }
+
+    for (int i = 0; i < mLoggedFillLayers; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "fill_layer_%d", mFillLayerOrder[i]);
+        WriteField(name, static_cast<double>(mFillLayerPixels[i]), 0);
+    }
+
+    if (mLogJson) {
+        std::fprintf(mLogFile, "{%s}\n", mLogLine.c_str());
+    } else {
+        if (!mLogHeaderWritten) {
+            std::fprintf(mLogFile, "%s\n", mLogHeader.c_str());
+        }
+        std::fprintf(mLogFile, "%s\n", mLogLine.c_str());
+    }
+
+    mLogHeaderWritten = true;
+}
+
+void Stats::WriteField(const char* name, double value, int precision) {
+    char buffer[64];
+
+    if (!mLogLine.empty()) {
+        mLogLine += ',';
+    }
+
+    if (mLogJson) {
+        std::snprintf(buffer, sizeof(buffer), "\"%s\":%.*f", name, precision, value);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+
+        if (!mLogHeaderWritten) {
+            if (!mLogHeader.empty()) {
+                mLogHeader += ',';
+            }
+            mLogHeader += name;
+        }
+    }
+
+    mLogLine += buffer;
+}
+
+void Stats::DrawOverlay(SDL_Renderer* renderer) const {
+    const int barWidth = 2;
+    const int graphHeight = 100;
+    const float pixelsPerMs = graphHeight / 50.0f;
+
+    SDL_Rect background = { 8, 8, HistorySize * barWidth, graphHeight };
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &background);
+
+    for (int i = 0; i < mHistoryCount; ++i) {
+        int index = (mHistoryNext - mHistoryCount + i + HistorySize) % HistorySize;
+        float ms = mHistory[index];
+
+        if (ms <= 17.0f) {
+            SDL_SetRenderDrawColor(renderer, 64, 220, 64, 255);
+        } else if (ms <= 34.0f) {
+            SDL_SetRenderDrawColor(renderer, 230, 200, 40, 255);
+        } else {
+            SDL_SetRenderDrawColor(renderer, 230, 50, 50, 255);
+        }
+
+        int height = std::min(static_cast<int>(ms * pixelsPerMs), graphHeight);
+        SDL_Rect bar = { background.x + i * barWidth, background.y + graphHeight - height, barWidth, height };
+        SDL_RenderFillRect(renderer, &bar);
+    }
+
+    // 60 Hz budget line.
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 200);
+    int budgetY = background.y + graphHeight - static_cast<int>(16.6f * pixelsPerMs);
+    SDL_RenderDrawLine(renderer, background.x, budgetY, background.x + background.w, budgetY);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
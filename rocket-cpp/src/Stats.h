@@ -0,0 +1,178 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "HardwareCounters.h"
+#include "SDL.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+class Stats {
+public:
+    enum Phase {
+        EInput,
+        EUpdate,
+        EOutput,
+        ENumPhases
+    };
+
+    // Input-to-present latency buckets: <8, <16, <33, <50 and 50+ ms.
+    static const int LatencyBuckets = 5;
+
+    struct Frame {
+        float mFrameMs;
+        float mPhaseMs[ENumPhases];
+        int mActors;
+        int mPendingActors;
+        // Actors whose Update ran this frame; the rest were skipped by update level of detail.
+        int mActorUpdates;
+        int mSpritesDrawn;
+        int mTextures;
+        // Textures and sprite sheets loaded from disk during the frame.
+        int mTextureLoads;
+        std::uint64_t mAllocations;
+        std::uint64_t mFillPixels;
+        // Mean and worst audio callback time since the previous frame.
+        float mAudioCallbackMs;
+        float mAudioCallbackMaxMs;
+        int mAudioVoices;
+        float mMusicBufferedMs;
+        // Cumulative for the current track.
+        Uint32 mMusicUnderruns;
+        // Input events first shown by this frame's present, their worst latency and its histogram.
+        int mInputEvents;
+        float mInputLatencyMs;
+        int mInputLatencyHistogram[LatencyBuckets];
+        // Blocked in SDL_RenderPresent (part of the output phase) and sleeping in the frame pacer.
+        float mPresentMs;
+        float mPacingMs;
+        // Render resolution relative to the window, per axis.
+        float mRenderScale;
+        int mQualityLevel;
+        // Hardware counter deltas per phase; zero unless counters are enabled and available.
+        std::uint64_t mPhaseCounters[ENumPhases][HardwareCounters::ENumCounters];
+    };
+
+    Stats();
+    ~Stats();
+
+    bool OpenLog(const std::string& fileName);
+    void CloseLog();
+
+    void BeginFrame();
+    void EndFrame();
+
+    void BeginPhase(Phase phase);
+    void EndPhase(Phase phase);
+
+    // Samples CPU counters around every phase, on the calling thread, which must be the
+    // one that runs the phases. False when the platform or kernel does not allow it.
+    bool EnableHardwareCounters();
+
+    // Destination pixels written by a draw, bucketed by draw order to show overdraw per layer.
+    void AddFill(int drawOrder, int logicalPixels);
+
+    // Scale of the frame being drawn; fill is reported in logical pixels and converted with it.
+    void SetRenderScale(float scale) {
+        mCurrent.mRenderScale = scale;
+        mFillScale = scale * scale;
+    }
+
+    // Records the time from an input event's arrival to the present of the frame that reflects it.
+    void AddInputLatency(Uint64 inputTimestamp, Uint64 presentTimestamp);
+
+    Frame& GetCurrentFrame() {
+        return mCurrent;
+    }
+
+    const Frame& GetLastFrame() const {
+        return mLast;
+    }
+
+    std::uint64_t GetFrameCount() const {
+        return mFrameCount;
+    }
+
+    float GetPercentile50() const {
+        return mPercentile50;
+    }
+
+    float GetPercentile95() const {
+        return mPercentile95;
+    }
+
+    float GetPercentile99() const {
+        return mPercentile99;
+    }
+
+    // True for the frame in which the percentiles and summary were recomputed.
+    bool IsSummaryRefreshed() const {
+        return mSummaryRefreshed;
+    }
+
+    const char* GetSummary() const {
+        return mSummary;
+    }
+
+    bool IsOverlayEnabled() const {
+        return mOverlayEnabled;
+    }
+
+    void SetOverlayEnabled(bool enabled) {
+        mOverlayEnabled = enabled;
+    }
+
+    void DrawOverlay(SDL_Renderer* renderer) const;
+
+private:
+    static const int HistorySize = 256;
+    static const int MaxFillLayers = 8;
+
+    void RefreshSummary();
+    void WriteLogLine();
+    void WriteField(const char* name, double value, int precision);
+
+    Frame mCurrent;
+    Frame mLast;
+    std::uint64_t mFrameCount;
+
+    Uint64 mFrameStart;
+    Uint64 mPhaseStart[ENumPhases];
+    HardwareCounters mCounters;
+    std::uint64_t mPhaseCountersStart[ENumPhases][HardwareCounters::ENumCounters];
+    std::uint64_t mAllocationsAtFrameStart;
+    double mTicksToMs;
+
+    float mHistory[HistorySize];
+    int mHistoryCount;
+    int mHistoryNext;
+    float mSinceRefreshMs;
+    int mFramesSinceRefresh;
+
+    float mPercentile50;
+    float mPercentile95;
+    float mPercentile99;
+    bool mSummaryRefreshed;
+    char mSummary[256];
+
+    int mFillLayerOrder[MaxFillLayers];
+    std::uint64_t mFillLayerPixels[MaxFillLayers];
+    int mFillLayerCount;
+    float mFillScale;
+    // Layers present when the CSV header was written; later ones only count towards the total.
+    int mLoggedFillLayers;
+
+    // Worst latency since the summary was last refreshed.
+    float mRecentInputLatencyMs;
+
+    std::FILE* mLogFile;
+    bool mLogJson;
+    bool mLogHeaderWritten;
+    std::string mLogHeader;
+    std::string mLogLine;
+
+    bool mOverlayEnabled;
+};
+
+#endif // STATS_H
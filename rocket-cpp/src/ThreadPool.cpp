@@ -0,0 +1,87 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+    : mGeneration(0)
+    , mBusyWorkers(0)
+    , mStopping(false)
+    , mJob(nullptr)
+    , mJobCount(0)
+    , mNextJob(0) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+
+    for (int i = 1; i < threadCount; ++i) {
+        mWorkers.emplace_back(&ThreadPool::WorkerMain, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& job) {
+    if (count <= 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJob = &job;
+        mJobCount = count;
+        mNextJob.store(0, std::memory_order_relaxed);
+        mBusyWorkers = static_cast<int>(mWorkers.size());
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    RunJobs();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mBusyWorkers == 0; });
+    mJob = nullptr;
+}
+
+void ThreadPool::WorkerMain() {
+    unsigned int seenGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this, seenGeneration] { return mStopping || mGeneration != seenGeneration; });
+            if (mStopping) {
+                return;
+            }
+            seenGeneration = mGeneration;
+        }
+
+        RunJobs();
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            last = --mBusyWorkers == 0;
+        }
+        if (last) {
+            mDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::RunJobs() {
+    for (;;) {
+        int index = mNextJob.fetch_add(1, std::memory_order_relaxed);
+        if (index >= mJobCount) {
+            return;
+        }
+        (*mJob)(index);
+    }
+}
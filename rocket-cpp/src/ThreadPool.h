@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork/join loops. The calling thread joins in,
+// so a pool of N threads keeps N cores busy with N - 1 workers.
+class ThreadPool {
+public:
+    // Zero uses one thread per hardware thread.
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int GetThreadCount() const {
+        return static_cast<int>(mWorkers.size()) + 1;
+    }
+
+    // Calls job(i) once for every i in [0, count) and returns when all calls are done.
+    // Indices are handed out one at a time, so uneven jobs still balance.
+    void ParallelFor(int count, const std::function<void(int)>& job);
+
+private:
+    void WorkerMain();
+    void RunJobs();
+
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    // Bumped for every ParallelFor so sleeping workers can tell a new batch from a spurious wakeup.
+    unsigned int mGeneration;
+    int mBusyWorkers;
+    bool mStopping;
+
+    const std::function<void(int)>* mJob;
+    int mJobCount;
+    std::atomic<int> mNextJob;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,123 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include "SDL.h"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Writes plain values into a byte buffer from its start, growing it as needed; Finish
+// trims it to what was written. Pointers (textures, clips) are stored as they are,
+// so a snapshot is only meaningful for the world that wrote it.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<Uint8>& buffer)
+        : mBuffer(buffer)
+        , mOffset(0) {
+    }
+
+    void Finish() {
+        mBuffer.resize(mOffset);
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        WriteArray(&value, 1);
+    }
+
+    template <typename T>
+    void WriteArray(const T* values, std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot values must be trivially copyable");
+
+        std::size_t size = sizeof(T) * count;
+        if (mOffset + size > mBuffer.size()) {
+            mBuffer.resize(mOffset + size > mBuffer.size() * 2 ? mOffset + size : mBuffer.size() * 2);
+        }
+        if (count > 0) {
+            std::memcpy(&mBuffer[mOffset], values, size);
+        }
+        mOffset += size;
+    }
+
+private:
+    std::vector<Uint8>& mBuffer;
+    std::size_t mOffset;
+};
+
+// Reads values back in the order SnapshotWriter wrote them. A read past the end of
+// the buffer leaves its values untouched and fails the reader; every later read is skipped.
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::vector<Uint8>& buffer)
+        : mBuffer(buffer)
+        , mOffset(0)
+        , mFailed(false) {
+    }
+
+    template <typename T>
+    void Read(T& value) {
+        ReadArray(&value, 1);
+    }
+
+    template <typename T>
+    void ReadArray(T* values, std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot values must be trivially copyable");
+
+        if (mFailed || count > (mBuffer.size() - mOffset) / sizeof(T)) {
+            mFailed = true;
+            return;
+        }
+        if (count > 0) {
+            std::memcpy(values, &mBuffer[mOffset], sizeof(T) * count);
+        }
+        mOffset += sizeof(T) * count;
+    }
+
+    // For values that were read fine but do not fit the object reading them.
+    void Fail() {
+        mFailed = true;
+    }
+
+    bool HasFailed() const {
+        return mFailed;
+    }
+
+    bool IsAtEnd() const {
+        return mOffset == mBuffer.size();
+    }
+
+private:
+    const std::vector<Uint8>& mBuffer;
+    std::size_t mOffset;
+    bool mFailed;
+};
+
+// State of every actor and component of one Game, in one contiguous buffer that
+// is reused by later captures. Written by Game::SaveSnapshot, applied by
+// Game::RestoreSnapshot.
+class WorldSnapshot {
+public:
+    std::size_t GetSize() const {
+        return mData.size();
+    }
+
+    bool IsEmpty() const {
+        return mData.empty();
+    }
+
+    // Byte-wise, so two snapshots of one world are equal exactly when its state was.
+    bool Equals(const WorldSnapshot& other) const {
+        return mData == other.mData;
+    }
+
+private:
+    friend class Game;
+
+    // Actor count, then each actor's id and component count in update order, then game
+    // state, then each actor's block.
+    std::vector<Uint8> mData;
+};
+
+#endif // WORLD_SNAPSHOT_H